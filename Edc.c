@@ -2,31 +2,71 @@
 
 /* Do not change */
 #define CRC_MSG_SIZE    8       // CRC is usually processed over 8-bit bytes
-#define CRC_LUT_SIZE    256     // Max 2^32 sized LUT
+
+/* Dallas/Maxim CRC-8 LUT entries evaluated by the compiler (reflected 0x31) */
+#define CRC8_MAXIM_POLY_REFL    0x8C
+#define CRC8_MAXIM_BIT(crc)     (((crc) >> 1) ^ (((crc) & 0x01) ? CRC8_MAXIM_POLY_REFL : 0x00))
+#define CRC8_MAXIM_BYTE(idx)    CRC8_MAXIM_BIT(CRC8_MAXIM_BIT(CRC8_MAXIM_BIT(CRC8_MAXIM_BIT( \
+                                CRC8_MAXIM_BIT(CRC8_MAXIM_BIT(CRC8_MAXIM_BIT(CRC8_MAXIM_BIT(idx))))))))
+#define CRC8_MAXIM_ROW4(idx)    CRC8_MAXIM_BYTE((idx) + 0), CRC8_MAXIM_BYTE((idx) + 1), \
+                                CRC8_MAXIM_BYTE((idx) + 2), CRC8_MAXIM_BYTE((idx) + 3)
+#define CRC8_MAXIM_ROW16(idx)   CRC8_MAXIM_ROW4((idx) + 0), CRC8_MAXIM_ROW4((idx) + 4), \
+                                CRC8_MAXIM_ROW4((idx) + 8), CRC8_MAXIM_ROW4((idx) + 12)
+#define CRC8_MAXIM_ROW64(idx)   CRC8_MAXIM_ROW16((idx) + 0), CRC8_MAXIM_ROW16((idx) + 16), \
+                                CRC8_MAXIM_ROW16((idx) + 32), CRC8_MAXIM_ROW16((idx) + 48)
 
 /******************************************************************************/
-/*--------------------------Local Data Variables------------------------------*/
+/*-----------------------------Global Variables-------------------------------*/
 /******************************************************************************/
 
-/* "crcLutId" holds polynomials and "crcLut" holds LUT for corresponding index */
-/* Additionally, former stores info about other CRC parameters */
-static uint32_t crcLutId[CRC_MAX_DEVICE_COUNT][4];
-static uint32_t crcLut[CRC_MAX_DEVICE_COUNT][CRC_LUT_SIZE];
+/* Constant LUT (flash) - no RAM and no start-up generation needed */
+const uint8_t edcCrc8MaximLut[CRC_LUT_SIZE] = {
+    CRC8_MAXIM_ROW64(0), CRC8_MAXIM_ROW64(64), CRC8_MAXIM_ROW64(128), CRC8_MAXIM_ROW64(192)
+};
 
-/* LUT for bit swapping */
-static uint8_t bitSwapLut[16] = { 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
-                                  0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+#if CRC_MAX_DEVICE_COUNT > 0
 
 /******************************************************************************/
 /*--------------------------Local Data Structures-----------------------------*/
 /******************************************************************************/
 
+/* Generated LUT with its CRC parameters (referenced by CrcHandle_t) */
+struct CrcLut {
+    uint32_t        poly;
+    CrcPolySize_t   polySize;
+    bool            isInputRefl;
+    bool            isCrcRefl;
+    uint32_t        crcMask;                // Valid CRC bits
+    CrcSlicing_t    slicing;
+    const uint32_t  (*sliceLut)[CRC_LUT_SIZE];  // LUTs 1..7 of sliced config
+    uint32_t        lut[CRC_LUT_SIZE];      // Reflected LUT if input reflected, else MSB aligned
+};
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static CrcLut_t crcLut[CRC_MAX_DEVICE_COUNT];
+static uint8_t crcLutCount = 0;
 
+#if CRC_MAX_SLICED_COUNT > 0
+/* LUT k holds CRC of byte followed by k zero bytes (LUT 0 is in CrcLut_t) */
+static uint32_t crcSliceLut[CRC_MAX_SLICED_COUNT][CRC_SLICING_8 - 1][CRC_LUT_SIZE];
+static uint8_t crcSliceCount = 0;
+#endif
+
+/* LUT for bit swapping */
+static uint8_t bitSwapLut[16] = { 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+                                  0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
 
 /******************************************************************************/
 /*------------------------Local Function Prototypes---------------------------*/
 /******************************************************************************/
 
+static uint32_t UpdateCrc(CrcHandle_t crcHandle, uint32_t crcVal, const uint8_t *dataPtr, uint32_t dataLen);
+static uint32_t UpdateCrcSliced(CrcHandle_t crcHandle, uint32_t crcVal, const uint8_t *dataPtr, uint32_t dataLen);
+static uint32_t UpdateCrcBytes(CrcHandle_t crcHandle, uint32_t crcVal, const uint8_t *dataPtr, uint32_t dataLen);
+static uint32_t ReflectCrc(uint32_t crcVal, CrcPolySize_t polySize);
 static INLINE uint8_t BitSwap8(uint8_t byte);
 static INLINE uint16_t BitSwap16(uint16_t word);
 static INLINE uint32_t BitSwap32(uint32_t dword);
@@ -36,90 +76,145 @@ static INLINE uint32_t BitSwap32(uint32_t dword);
 /******************************************************************************/
 
 /*
- *  Generate LUT for the selected polynomial of CRCn
- *  WARNING: There is some issue in generating LUT data for CRC32, where
- *  polynomial has more than 6 hexadecimal digits (24 bytes)
+ *  Generate LUT for the selected polynomial of CRCn and return its handle
+ *  (NULL if parameters are invalid or no free LUT is left)
+ * 
+ *  Reflected input is handled by a reflected LUT (LSB-first shift register),
+ *  so input bytes never have to be bit-swapped during calculation. Normal LUT
+ *  is MSB aligned in 32 bits, so all CRC sizes share the same shift code.
+ * 
+ *  Sliced config also generates its extra LUTs (derived from LUT 0)
  */
-extern bool EDC_GenerateCrcLut(CrcConfig_t crcConfig)
+extern CrcHandle_t EDC_GenerateCrcLut(CrcConfig_t crcConfig)
 {
-    uint8_t poly = crcConfig.poly;
-    uint8_t polySize = crcConfig.polySize;
-    uint8_t isInputRefl = crcConfig.isInputReflected;
-    uint8_t isCrcRefl = crcConfig.isCrcReflected;
+    uint32_t poly = crcConfig.poly;
+    CrcPolySize_t polySize = crcConfig.polySize;
+    bool isInputRefl = crcConfig.isInputReflected;
+    bool isCrcRefl = crcConfig.isCrcReflected;
+    CrcSlicing_t slicing = crcConfig.slicing;
     
-    /* Poly check */
-    if (poly == 0)
+    /* CRC size check */
+    if ((polySize != CRC_POLY_SIZE_8) && (polySize != CRC_POLY_SIZE_16) && (polySize != CRC_POLY_SIZE_32))
     {
-        return false;
+        return NULL;
     }
     
-    /* CRC size check */
-    if ((polySize != 8) && (polySize != 16) && (polySize != 32) )
+    uint32_t crcMask = (polySize == CRC_POLY_SIZE_32) ? 0xFFFFFFFF : ((1UL << polySize) - 1);
+    
+    /* Poly check */
+    if (((poly & crcMask) == 0) || ((poly & ~crcMask) != 0))
     {
-        return false;
+        return NULL;
     }
     
-    /* The following code determines where to generate LUT in given array */
+    /* Slicing check */
+    if ((slicing != CRC_SLICING_NONE) && (slicing != CRC_SLICING_4) && (slicing != CRC_SLICING_8))
+    {
+        return NULL;
+    }
     
-    /* Check if duplicate polynomial value exists */
-    for (uint8_t idx = 0; idx < CRC_MAX_DEVICE_COUNT; idx++)
+    /* Same configuration already generated - share its LUT */
+    for (uint8_t idx = 0; idx < crcLutCount; idx++)
     {
-        if (poly == crcLutId[idx][0])
+        if ((crcLut[idx].poly == poly) && (crcLut[idx].polySize == polySize) &&
+            (crcLut[idx].isInputRefl == isInputRefl) && (crcLut[idx].isCrcRefl == isCrcRefl) &&
+            (crcLut[idx].slicing == slicing))
         {
-            return false;
+            return &crcLut[idx];
         }
     }
     
-    static uint8_t deviceIdx = 0;
     /* Max amount of devices check */
-    if (deviceIdx >= CRC_MAX_DEVICE_COUNT)
+    if (crcLutCount >= CRC_MAX_DEVICE_COUNT)
     {
-        return false;
+        return NULL;
     }
     
-    /* These parameters are accessed when CRC is calculated (based on poly) */
-    crcLutId[deviceIdx][0] = poly;
-    crcLutId[deviceIdx][1] = polySize;
-    crcLutId[deviceIdx][2] = isInputRefl;
-    crcLutId[deviceIdx][3] = isCrcRefl;
+    /* Free extra LUTs check */
+#if CRC_MAX_SLICED_COUNT > 0
+    if ((slicing != CRC_SLICING_NONE) && (crcSliceCount >= CRC_MAX_SLICED_COUNT))
+    {
+        return NULL;
+    }
+#else
+    if (slicing != CRC_SLICING_NONE)
+    {
+        return NULL;
+    }
+#endif
     
-    /* The following code generates CRC LUT */
+    CrcLut_t *crcHandle = &crcLut[crcLutCount];
     
-    uint64_t alignMask, polyMask;
+    /* These parameters are accessed when CRC is calculated */
+    crcHandle->poly = poly;
+    crcHandle->polySize = polySize;
+    crcHandle->isInputRefl = isInputRefl;
+    crcHandle->isCrcRefl = isCrcRefl;
+    crcHandle->crcMask = crcMask;
+    crcHandle->slicing = slicing;
+    crcHandle->sliceLut = NULL;
+    
+    uint32_t reflPoly = ReflectCrc(poly, polySize);
+    uint32_t alignPoly = poly << (32 - polySize);
     uint32_t crcVal;
     
     /* Generate CRC for each of possible input - LUT */
     for (uint32_t crcIdx = 0; crcIdx < CRC_LUT_SIZE; crcIdx++)
     {
-        /* Initial partial CRC value (adding zeros to the right side) */
-        crcVal = crcIdx << polySize;
-        /* Adding zeros to polynomial's right side */
-        polyMask = poly << (CRC_MSG_SIZE - 1);
-        /* Starting point for XORing individual bits of poly-sized bit chunk */
-        alignMask = 1 << (CRC_MSG_SIZE + polySize - 1);
-        
-        /* Loop through all bits of each partial remainder */
-        for (uint8_t bitIdx = 0; bitIdx < CRC_MSG_SIZE; bitIdx++)
+        /* LSB-first: shift right with reflected polynomial */
+        if (isInputRefl)
         {
-            /* XOR when "polyMask" and current partial remainder's MSB align */
-            if (crcVal & alignMask)
+            crcVal = crcIdx;
+            
+            for (uint8_t bitIdx = 0; bitIdx < CRC_MSG_SIZE; bitIdx++)
             {
-                crcVal ^= polyMask;
-                crcVal ^= alignMask;
+                crcVal = (crcVal & 0x01) ? ((crcVal >> 1) ^ reflPoly) : (crcVal >> 1);
             }
+        }
+        /* MSB-first: byte enters at the top of MSB aligned CRC register */
+        else
+        {
+            crcVal = crcIdx << (32 - CRC_MSG_SIZE);
             
-            polyMask >>= 1;
-            alignMask >>= 1;
+            for (uint8_t bitIdx = 0; bitIdx < CRC_MSG_SIZE; bitIdx++)
+            {
+                crcVal = (crcVal & 0x80000000) ? ((crcVal << 1) ^ alignPoly) : (crcVal << 1);
+            }
         }
         
         /* CRC of current LUT index is stored in LUT at current index */
-        crcLut[deviceIdx][crcIdx] = crcVal;
+        crcHandle->lut[crcIdx] = crcVal;
     }
     
+#if CRC_MAX_SLICED_COUNT > 0
+    /* Extra LUTs: previous LUT entry shifted by one more zero byte */
+    if (slicing != CRC_SLICING_NONE)
+    {
+        uint32_t (*sliceLut)[CRC_LUT_SIZE] = crcSliceLut[crcSliceCount];
+        const uint32_t *prevLut = crcHandle->lut;
+        
+        for (uint8_t lutIdx = 0; lutIdx < (slicing - 1); lutIdx++)
+        {
+            for (uint32_t crcIdx = 0; crcIdx < CRC_LUT_SIZE; crcIdx++)
+            {
+                crcVal = prevLut[crcIdx];
+                sliceLut[lutIdx][crcIdx] = isInputRefl ? ((crcVal >> 8) ^ crcHandle->lut[crcVal & 0xFF]) :
+                                                         ((crcVal << 8) ^ crcHandle->lut[crcVal >> 24]);
+            }
+            
+            prevLut = sliceLut[lutIdx];
+        }
+        
+        /* Index 0 is LUT 1 */
+        crcHandle->sliceLut = (const uint32_t (*)[CRC_LUT_SIZE])sliceLut;
+        crcSliceCount++;
+    }
+#endif
+    
     /* Next CRC LUT generated at next index */
-    deviceIdx++;
+    crcLutCount++;
     
-    return true;
+    return crcHandle;
 }
 
 
@@ -130,107 +225,213 @@ extern bool EDC_GenerateCrcLut(CrcConfig_t crcConfig)
  *  Returns all ones if any input restriction triggered, while all zeros is
  *  considered a valid return (when comparing CRC code with valid CRC'ed message)
  */
-extern uint32_t EDC_CalculateCrc(const uint32_t poly, void *dPtr, const uint32_t dataLen)
+extern uint32_t EDC_CalculateCrc(CrcHandle_t crcHandle, const void *dPtr, const uint32_t dataLen)
 {    
     /* Input check */
-    if ((dataLen == 0) || (dPtr == NULL))
+    if ((crcHandle == NULL) || (dataLen == 0) || (dPtr == NULL))
     {
         return 0xFFFFFFFF;  // 0x00 reserved for valid CRC processed value
     }
     
-    /* Find LUT index in "crcLut" for current polynomial */
-    uint8_t lutIdx;
-    for (uint8_t idx = 0; idx < CRC_MAX_DEVICE_COUNT; idx++)
+    CrcState_t crcState = {.crcHandle = crcHandle, .crcVal = UpdateCrc(crcHandle, 0, dPtr, dataLen)};
+    
+    return EDC_CrcFinal(&crcState);
+}
+
+
+/*
+ *  Start running CRC calculation (data is then passed in any chunk sizes)
+ */
+extern bool EDC_CrcInit(CrcState_t *crcState, CrcHandle_t crcHandle)
+{
+    /* Inputs check */
+    if ((crcState == NULL) || (crcHandle == NULL))
     {
-        if (crcLutId[idx][0] == poly)
-        {
-            lutIdx = idx;
-            break;
-        }
+        return false;
     }
     
-    uint8_t *dataPtr;
-    CrcPolySize_t polySize = crcLutId[lutIdx][1];
-    bool isInputRefl = crcLutId[lutIdx][2];
-    bool isCrcRefl = crcLutId[lutIdx][3];
-
-    /* Reflect all input bytes */
-    uint8_t data[dataLen];
-    if (isInputRefl == true)
+    crcState->crcHandle = crcHandle;
+    crcState->crcVal = 0;
+    
+    return true;
+}
+
+
+/*
+ *  Process next chunk of data
+ */
+extern void EDC_CrcUpdate(CrcState_t *crcState, const void *dPtr, const uint32_t dataLen)
+{
+    /* Inputs check */
+    if ((crcState == NULL) || (crcState->crcHandle == NULL) || (dPtr == NULL))
     {
-        for (uint32_t idx = 0; idx < dataLen; idx++)
-        {
-            data[idx] = BitSwap8(*((uint8_t *)dPtr + idx));
-        }
-        dataPtr = &data[0];
+        return;
     }
-    else
+    
+    crcState->crcVal = UpdateCrc(crcState->crcHandle, crcState->crcVal, dPtr, dataLen);
+}
+
+
+/*
+ *  Get CRC of all data processed so far (state stays valid for more updates)
+ */
+extern uint32_t EDC_CrcFinal(const CrcState_t *crcState)
+{
+    /* Input check */
+    if ((crcState == NULL) || (crcState->crcHandle == NULL))
     {
-        dataPtr = dPtr;
+        return 0xFFFFFFFF;
     }
     
-    uint64_t crcIdx, crcVal = 0;
+    CrcHandle_t crcHandle = crcState->crcHandle;
+    uint32_t crcVal = crcState->crcVal;
     
-    /* XOR all elements of input data */
-    if (polySize == CRC_POLY_SIZE_8)
+    /* Normal CRC register is MSB aligned */
+    if (!crcHandle->isInputRefl)
     {
-        for (uint32_t idx = 0; idx < dataLen; idx++)
+        crcVal >>= (32 - crcHandle->polySize);
+    }
+    
+    crcVal &= crcHandle->crcMask;
+    
+    /* Reflected algorithm yields reflected CRC - swap only if not requested */
+    if (crcHandle->isInputRefl != crcHandle->isCrcRefl)
+    {
+        crcVal = ReflectCrc(crcVal, crcHandle->polySize);
+    }
+    
+    return crcVal;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Update raw CRC register with the kernel selected by CRC config
+ */
+static uint32_t UpdateCrc(CrcHandle_t crcHandle, uint32_t crcVal, const uint8_t *dataPtr, uint32_t dataLen)
+{
+    if (crcHandle->slicing != CRC_SLICING_NONE)
+    {
+        return UpdateCrcSliced(crcHandle, crcVal, dataPtr, dataLen);
+    }
+    
+    return UpdateCrcBytes(crcHandle, crcVal, dataPtr, dataLen);
+}
+
+
+/*
+ *  Slicing-by-4/8 update: one lookup per byte, but all lookups of a word are
+ *  independent instead of chained through the CRC register (rest byte-wise)
+ */
+static uint32_t UpdateCrcSliced(CrcHandle_t crcHandle, uint32_t crcVal, const uint8_t *dataPtr, uint32_t dataLen)
+{
+    const uint32_t *lut = crcHandle->lut;
+    const uint32_t (*sliceLut)[CRC_LUT_SIZE] = crcHandle->sliceLut;  // sliceLut[k - 1] is LUT k
+    uint32_t wordCount = dataLen / crcHandle->slicing;
+    uint32_t word1, word2;
+    
+    /* Reflected: little-endian words, first byte uses the highest LUT */
+    if (crcHandle->isInputRefl)
+    {
+        for (uint32_t idx = 0; idx < wordCount; idx++, dataPtr += crcHandle->slicing)
         {
-            crcIdx = crcVal ^ *dataPtr;
-            crcVal = crcLut[lutIdx][crcIdx];
-            crcVal &= 0xFF;
-            dataPtr++;
+            word1 = crcVal ^ ((uint32_t)dataPtr[0] | ((uint32_t)dataPtr[1] << 8) |
+                              ((uint32_t)dataPtr[2] << 16) | ((uint32_t)dataPtr[3] << 24));
+            
+            if (crcHandle->slicing == CRC_SLICING_8)
+            {
+                word2 = (uint32_t)dataPtr[4] | ((uint32_t)dataPtr[5] << 8) |
+                        ((uint32_t)dataPtr[6] << 16) | ((uint32_t)dataPtr[7] << 24);
+                
+                crcVal = sliceLut[6][word1 & 0xFF] ^ sliceLut[5][(word1 >> 8) & 0xFF] ^
+                         sliceLut[4][(word1 >> 16) & 0xFF] ^ sliceLut[3][word1 >> 24] ^
+                         sliceLut[2][word2 & 0xFF] ^ sliceLut[1][(word2 >> 8) & 0xFF] ^
+                         sliceLut[0][(word2 >> 16) & 0xFF] ^ lut[word2 >> 24];
+            }
+            else
+            {
+                crcVal = sliceLut[2][word1 & 0xFF] ^ sliceLut[1][(word1 >> 8) & 0xFF] ^
+                         sliceLut[0][(word1 >> 16) & 0xFF] ^ lut[word1 >> 24];
+            }
         }
-        
-        /* Reflect result */
-        if (isCrcRefl == true)
+    }
+    /* Normal: big-endian words against MSB aligned CRC register */
+    else
+    {
+        for (uint32_t idx = 0; idx < wordCount; idx++, dataPtr += crcHandle->slicing)
         {
-            crcVal = BitSwap8(crcVal);
+            word1 = crcVal ^ (((uint32_t)dataPtr[0] << 24) | ((uint32_t)dataPtr[1] << 16) |
+                              ((uint32_t)dataPtr[2] << 8) | (uint32_t)dataPtr[3]);
+            
+            if (crcHandle->slicing == CRC_SLICING_8)
+            {
+                word2 = ((uint32_t)dataPtr[4] << 24) | ((uint32_t)dataPtr[5] << 16) |
+                        ((uint32_t)dataPtr[6] << 8) | (uint32_t)dataPtr[7];
+                
+                crcVal = sliceLut[6][word1 >> 24] ^ sliceLut[5][(word1 >> 16) & 0xFF] ^
+                         sliceLut[4][(word1 >> 8) & 0xFF] ^ sliceLut[3][word1 & 0xFF] ^
+                         sliceLut[2][word2 >> 24] ^ sliceLut[1][(word2 >> 16) & 0xFF] ^
+                         sliceLut[0][(word2 >> 8) & 0xFF] ^ lut[word2 & 0xFF];
+            }
+            else
+            {
+                crcVal = sliceLut[2][word1 >> 24] ^ sliceLut[1][(word1 >> 16) & 0xFF] ^
+                         sliceLut[0][(word1 >> 8) & 0xFF] ^ lut[word1 & 0xFF];
+            }
         }
     }
-    else if (polySize == CRC_POLY_SIZE_16)
+    
+    return UpdateCrcBytes(crcHandle, crcVal, dataPtr, dataLen % crcHandle->slicing);
+}
+
+
+/*
+ *  Byte-wise LUT update of raw CRC register
+ */
+static uint32_t UpdateCrcBytes(CrcHandle_t crcHandle, uint32_t crcVal, const uint8_t *dataPtr, uint32_t dataLen)
+{
+    const uint32_t *lut = crcHandle->lut;
+    
+    /* Reflected LUT: CRC register shifts towards LSB */
+    if (crcHandle->isInputRefl)
     {
         for (uint32_t idx = 0; idx < dataLen; idx++)
         {
-            crcIdx = (crcVal >> 8) ^ *dataPtr;
-            crcVal = (crcVal << 8) ^ crcLut[lutIdx][crcIdx];
-            crcVal &= 0xFFFF;
-            dataPtr++;
-        }
-        
-        /* Reflect result */
-        if (isCrcRefl == true)
-        {
-            crcVal = BitSwap16(crcVal);
+            crcVal = (crcVal >> 8) ^ lut[(crcVal ^ dataPtr[idx]) & 0xFF];
         }
     }
-    else if (polySize == CRC_POLY_SIZE_32)
+    /* Normal LUT: MSB aligned CRC register shifts towards MSB */
+    else
     {
         for (uint32_t idx = 0; idx < dataLen; idx++)
         {
-            crcIdx = (crcVal >> 24) ^ *dataPtr;
-            crcVal = (crcVal << 8) ^ crcLut[lutIdx][crcIdx];
-            crcVal &= 0xFFFFFFFF;
-            dataPtr++;
-        }
-        
-        /* Reflect result */
-        if (isCrcRefl == true)
-        {
-            crcVal = BitSwap32(crcVal);
+            crcVal = (crcVal << 8) ^ lut[(crcVal >> 24) ^ dataPtr[idx]];
         }
     }
-    else
+    
+    return crcVal;
+}
+
+
+/*
+ *  Reflect CRC value of given size
+ */
+static uint32_t ReflectCrc(uint32_t crcVal, CrcPolySize_t polySize)
+{
+    if (polySize == CRC_POLY_SIZE_8)
     {
-        return 0xFFFFFFFF;  // 0x00 reserved for valid CRC processed value
+        return BitSwap8(crcVal);
+    }
+    else if (polySize == CRC_POLY_SIZE_16)
+    {
+        return BitSwap16(crcVal);
     }
     
-    return (uint32_t)crcVal;
+    return BitSwap32(crcVal);
 }
 
-/******************************************************************************/
-/*------------------------Local Function Definitions--------------------------*/
-/******************************************************************************/
 
 /*
  *  Optimized bit reflection up to 8-bits
@@ -269,5 +470,7 @@ static INLINE uint32_t BitSwap32(uint32_t dword)
     uint8_t res3 = (bitSwapLut[n3 & 0xF] << 4) | bitSwapLut[n3 >> 4];
     uint8_t res4 = (bitSwapLut[n4 & 0xF] << 4) | bitSwapLut[n4 >> 4];
 	
-    return (res1 << 24) | (res2 << 16) | (res3 << 8) | (res4 << 0);
-}
\ No newline at end of file
+    return ((uint32_t)res1 << 24) | (res2 << 16) | (res3 << 8) | (res4 << 0);
+}
+
+#endif  /* CRC_MAX_DEVICE_COUNT > 0 */
\ No newline at end of file
@@ -23,7 +23,19 @@
 #endif
 
 /** Max. amount of CRC devices using this library (affects memory consumption) **/
+/** Set to 0 to drop runtime LUTs when only EDC_CalculateCrc8Maxim() is used **/
+#ifndef CRC_MAX_DEVICE_COUNT
 #define CRC_MAX_DEVICE_COUNT   10
+#endif
+
+/** Max. amount of sliced CRC configs (7 KB of RAM each for extra LUTs) **/
+/** Default 0: sliced configs not generated (EDC_GenerateCrcLut returns NULL) **/
+#ifndef CRC_MAX_SLICED_COUNT
+#define CRC_MAX_SLICED_COUNT   0
+#endif
+
+/** LUT size of byte-wise CRC calculation **/
+#define CRC_LUT_SIZE    256
 
 /******************************************************************************/
 /*----------------------------Enumeration Types-------------------------------*/
@@ -35,6 +47,13 @@ typedef enum {
     CRC_POLY_SIZE_32 = 32
 } CrcPolySize_t;
 
+/* Bytes processed per loop iteration (slicing needs extra LUTs per config) */
+typedef enum {
+    CRC_SLICING_NONE = 0,       // Byte-wise, 1 LUT
+    CRC_SLICING_4 = 4,          // 4 LUTs, 32-bit word per iteration
+    CRC_SLICING_8 = 8           // 8 LUTs, 64-bit word per iteration
+} CrcSlicing_t;
+
 /******************************************************************************/
 /*-----------------------------Data Structures--------------------------------*/
 /******************************************************************************/
@@ -44,17 +63,73 @@ typedef struct {
     const CrcPolySize_t polySize;
     const bool isInputReflected;
     const bool isCrcReflected;
+    const CrcSlicing_t slicing;     // Optional, byte-wise if not set
 } CrcConfig_t;
 
+/* Opaque generated LUT, NULL if generation failed */
+typedef struct CrcLut CrcLut_t;
+typedef const CrcLut_t *CrcHandle_t;
+
+/* Running CRC of data processed in chunks (init/update/final) */
+typedef struct {
+    CrcHandle_t     crcHandle;
+    uint32_t        crcVal;     // Raw CRC register (reflected: LSB, normal: MSB aligned)
+} CrcState_t;
+
+/******************************************************************************/
+/*------------------------------Global Variables------------------------------*/
+/******************************************************************************/
+
+/** Dallas/Maxim (1-Wire) CRC-8 LUT generated at compile time (flash) **/
+extern const uint8_t edcCrc8MaximLut[CRC_LUT_SIZE];
+
 /******************************************************************************/
 /*---------------------------- Function Prototypes----------------------------*/
 /******************************************************************************/
 
-bool EDC_GenerateCrcLut(CrcConfig_t crcConfig);
-uint32_t EDC_CalculateCrc(const uint32_t poly, void *dPtr, const uint32_t dataLen);
+#if CRC_MAX_DEVICE_COUNT > 0
+CrcHandle_t EDC_GenerateCrcLut(CrcConfig_t crcConfig);
+uint32_t EDC_CalculateCrc(CrcHandle_t crcHandle, const void *dPtr, const uint32_t dataLen);
+bool EDC_CrcInit(CrcState_t *crcState, CrcHandle_t crcHandle);
+void EDC_CrcUpdate(CrcState_t *crcState, const void *dPtr, const uint32_t dataLen);
+uint32_t EDC_CrcFinal(const CrcState_t *crcState);
+#endif
 
 /******************************************************************************/
 /*-----------------------------Function In-lines------------------------------*/
 /******************************************************************************/
 
+/*
+ *  Update running Dallas/Maxim CRC-8 with one byte (start with 0x00, no
+ *  final step needed - 0x00 after CRC byte means valid data)
+ */
+static INLINE uint8_t EDC_UpdateCrc8Maxim(uint8_t crcVal, uint8_t dataByte)
+{
+    return edcCrc8MaximLut[crcVal ^ dataByte];
+}
+
+
+/*
+ *  Calculate Dallas/Maxim CRC-8 (poly 0x31, reflected) with constant LUT
+ *  (returns 0x00 if CRC byte is included at the end of valid data)
+ */
+static INLINE uint8_t EDC_CalculateCrc8Maxim(const void *dPtr, const uint32_t dataLen)
+{
+    const uint8_t *dataPtr = dPtr;
+    uint8_t crcVal = 0x00;
+    
+    /* Input check */
+    if ((dataLen == 0) || (dPtr == NULL))
+    {
+        return 0xFF;    // 0x00 reserved for valid CRC processed value
+    }
+    
+    for (uint32_t idx = 0; idx < dataLen; idx++)
+    {
+        crcVal = EDC_UpdateCrc8Maxim(crcVal, dataPtr[idx]);
+    }
+    
+    return crcVal;
+}
+
 #endif /* EDC_H */
\ No newline at end of file
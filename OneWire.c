@@ -1,238 +1,694 @@
 #include "OneWire.h"
 
+/** Pin mask of bus in pin levels read by ReadPins (single pin bus - bit 0) **/
+#if OW_MULTI_BUS
+#define BUS_PIN_MASK(pinCode)   PIO_PIN_MASK(pinCode)
+#else
+#define BUS_PIN_MASK(pinCode)   ((void)(pinCode), 0x01)
+#endif
+
 /******************************************************************************/
-/*--------------------------Local Data Variables------------------------------*/
+/*------------------------Local Function Prototypes---------------------------*/
 /******************************************************************************/
 
+/** Basic OW protocol functions **/
+static INLINE void SetBit(OwBus_t *bus);
+static INLINE void ClearBit(OwBus_t *bus);
+static INLINE uint8_t ReadBit(OwBus_t *bus);
+static INLINE uint32_t Reset(OwBus_t *bus);
+static INLINE uint8_t ReadLevel(OwBus_t *bus);
+static INLINE void PullLow(OwBus_t *bus);
+static INLINE void Release(OwBus_t *bus, const uint32_t pinCode);
+static INLINE uint32_t ReadPins(OwBus_t *bus);
 
+/** Latency-bounded OW protocol functions **/
+static void TransferBounded(OwBus_t *bus, uint8_t *dataByte, uint16_t bitCount, bool isRead);
+static uint32_t ResetBounded(OwBus_t *bus);
 
-/******************************************************************************/
-/*--------------------------Local Data Structures-----------------------------*/
-/******************************************************************************/
+/** Bus statistics functions **/
+static INLINE void AddBusyTime(OwBus_t *bus, uint32_t startTick);
+static INLINE void AddMaskedTime(OwBus_t *bus, uint32_t startTick);
 
-/** Protocol delays for speed mode control **/
-static struct {
-    uint16_t a;
-    uint16_t b;
-    uint16_t c;
-    uint16_t d;
-    uint16_t e;
-    uint16_t f;
-    uint16_t g;
-    uint16_t h;
-    uint16_t i;
-    uint16_t j;
-} owDelay;
+/** Trace functions **/
+static INLINE void Trace(OwBus_t *bus, OwTraceType_t type, uint32_t pinMask);
+static void TraceEvent(OwTrace_t *trace, OwTraceType_t type, uint32_t pinMask);
 
-/******************************************************************************/
-/*------------------------Local Function Prototypes---------------------------*/
-/******************************************************************************/
+/** Timing calibration functions **/
+static void CompensateDelay(OwBus_t *bus);
+static INLINE uint16_t SubOverhead(uint16_t delayUs, uint32_t overheadNs);
+static INLINE uint32_t TicksToNs(uint32_t coreTicks, uint32_t sysFreq);
 
-/** Basic OW protocol functions **/
-static INLINE void SetBit(const uint32_t pinCode);
-static INLINE void ClearBit(const uint32_t pinCode);
-static INLINE uint8_t ReadBit(const uint32_t pinCode);
-static INLINE uint8_t Reset(const uint32_t pinCode);
+/** Transport backend OW protocol functions **/
+static uint32_t TransportReset(OwBus_t *bus);
+static void TransportTransfer(OwBus_t *bus, uint8_t *dataByte, uint16_t bitCount, bool isRead);
+
+/** Multi-bus OW protocol functions **/
+static void TransferMulti(OwBus_t *bus, uint8_t *dataBuff, uint8_t dataLen, bool isRead);
+static INLINE uint32_t SubGroup(const uint32_t groupCode, uint32_t pinMask);
 
 /******************************************************************************/
 /*----------------------External Function Definitions-------------------------*/
 /******************************************************************************/
 
 /*
- *  Configure OW bus for operation (requires delay configuration)
+ *  Initialize bus context and configure OW bus for operation (counters are
+ *  cleared, latency-bounded masking is off, slots are bit-banged)
  */
-extern bool OW_ConfigBus(OwConfig_t owConfig)
+extern bool OW_ConfigBus(OwBus_t *bus, OwConfig_t owConfig)
 {
+    /* Inputs check */
+    if ((bus == NULL) || (owConfig.pinCode == 0))
+    {
+        return false;
+    }
+    
+    *bus = (OwBus_t){.pinCode = owConfig.pinCode};
+    
     /* Idle state HIGH (external pull-up required due to direction change) */
-    PIO_ConfigGpioPin(owConfig.pinCode, PIO_TYPE_DIGITAL, PIO_DIR_INPUT);
+    PIO_ConfigGpioPin(bus->pinCode, PIO_TYPE_DIGITAL, PIO_DIR_INPUT);
     
     /* Configure speed mode */
-    OW_ConfigSpeedMode(owConfig.speedMode);
+    OW_ConfigSpeedMode(bus, owConfig.speedMode);
     
     return true;
 }
 
 
+/*
+ *  Get amount of buses (pins) in pin group
+ */
+extern uint8_t OW_GetBusCount(const OwBus_t *bus)
+{
+    uint32_t pinMask = BUS_PIN_MASK(bus->pinCode);
+    uint8_t busCount = 0;
+    
+    while (pinMask)
+    {
+        pinMask &= pinMask - 1;
+        busCount++;
+    }
+    
+    return busCount;
+}
+
+
 /*
  *  Configure speed mode of OW communication
  */
-extern void OW_ConfigSpeedMode(OwSpeedMode_t speedMode)
+extern void OW_ConfigSpeedMode(OwBus_t *bus, OwSpeedMode_t speedMode)
 {
+    bus->speedMode = speedMode;
+    
+    if (bus->transport != NULL)
+    {
+        bus->transport->configSpeed(bus->transportCtx, speedMode);
+    }
+    
     switch(speedMode)
     {
         case OW_OVERLOAD_SPEED:
-            owDelay.a = 2;
-            owDelay.b = 8;
-            owDelay.c = 8;
-            owDelay.d = 3;
-            owDelay.e = 1;
-            owDelay.f = 7;
-            owDelay.g = 3;
-            owDelay.h = 70;
-            owDelay.i = 8;
-            owDelay.j = 40;
+            bus->delay.a = 2;
+            bus->delay.b = 8;
+            bus->delay.c = 8;
+            bus->delay.d = 3;
+            bus->delay.e = 1;
+            bus->delay.f = 7;
+            bus->delay.g = 3;
+            bus->delay.h = 70;
+            bus->delay.i = 8;
+            bus->delay.j = 40;
             break;
         /* This is unofficial mode */
         case OW_HIGH_SPEED:
-            owDelay.a = 6;
-            owDelay.b = 35;
-            owDelay.c = 40;
-            owDelay.d = 5;
-            owDelay.e = 8;
-            owDelay.f = 25;
-            owDelay.g = 0;
-            owDelay.h = 300;
-            owDelay.i = 70;
-            owDelay.j = 120;
+            bus->delay.a = 6;
+            bus->delay.b = 35;
+            bus->delay.c = 40;
+            bus->delay.d = 5;
+            bus->delay.e = 8;
+            bus->delay.f = 25;
+            bus->delay.g = 0;
+            bus->delay.h = 300;
+            bus->delay.i = 70;
+            bus->delay.j = 120;
             break;
         case OW_STANDARD_SPEED:
         default:
-            owDelay.a = 6;
-            owDelay.b = 64;
-            owDelay.c = 60;
-            owDelay.d = 10;
-            owDelay.e = 9;
-            owDelay.f = 55;
-            owDelay.g = 0;
-            owDelay.h = 480;
-            owDelay.i = 70;
-            owDelay.j = 410;
+            bus->delay.a = 6;
+            bus->delay.b = 64;
+            bus->delay.c = 60;
+            bus->delay.d = 10;
+            bus->delay.e = 9;
+            bus->delay.f = 55;
+            bus->delay.g = 0;
+            bus->delay.h = 480;
+            bus->delay.i = 70;
+            bus->delay.j = 410;
             break;
     }
+    
+    /* Trim datasheet delays by measured call overhead */
+    CompensateDelay(bus);
 }
 
 
 /*
- *  Reset the OW bus and return presence detected
+ *  Configure latency-bounded mode: interrupts are masked only around timing
+ *  critical parts of slots and kept masked over following slots only while
+ *  the masked time stays within "maxMaskedUs" (0 - mask whole transfers)
  */
-extern bool OW_Reset(const uint32_t pinCode)
+extern void OW_ConfigMaxMasked(OwBus_t *bus, uint16_t maxMaskedUs)
 {
-    return !Reset(pinCode);
+    bus->maxMaskedUs = maxMaskedUs;
 }
 
 
 /*
- *  Write one bit (used primarily for ROM search)
+ *  Hand slot generation over to a transport backend (NULL - bit-banging),
+ *  backend is set to the current speed mode
+ */
+extern void OW_ConfigTransport(OwBus_t *bus, const OwTransport_t *transport, void *context)
+{
+    bus->transport = transport;
+    bus->transportCtx = context;
+    
+    if (transport != NULL)
+    {
+        transport->configSpeed(context, bus->speedMode);
+    }
+}
+
+
+/*
+ *  Set strong pull-up switch of a parasite powered bus, driven to "isActiveLow"
+ *  level when enabled (pinCode 0 - bus pin itself is driven HIGH instead)
+ */
+extern void OW_ConfigPullup(OwBus_t *bus, const uint32_t pinCode, bool isActiveLow)
+{
+    bus->pullupPinCode = pinCode;
+    bus->isPullupActiveLow = isActiveLow;
+    
+    /* Switch off before it becomes an output */
+    if (pinCode != 0)
+    {
+        OW_SetPullup(bus, false);
+        PIO_ConfigGpioPin(pinCode, PIO_TYPE_DIGITAL, PIO_DIR_OUTPUT);
+    }
+}
+
+
+/*
+ *  Measure CPU overhead of pin access and delay calls against core timer and
+ *  shorten slot delays by it, so that bus timing matches the datasheet also
+ *  at high and overdrive speed (call at startup with bus idle, stays valid
+ *  across speed mode changes until next OW_ConfigBus)
  */
-extern void OW_WriteBit(const uint32_t pinCode, const uint8_t dataBit)
+extern bool OW_CalibrateTiming(OwBus_t *bus)
 {
+    uint32_t sysFreq = OSC_GetSysFreq();
+    uint32_t startTick, readTicks, pioTicks, delayTicks;
+    uint32_t delayNs;
+    
+    /* Inputs check (transport backends time slots in hardware) */
+    if ((bus == NULL) || (bus->transport != NULL) || (sysFreq == 0))
+    {
+        return false;
+    }
+    
     /* Obtain old interrupt status and disable interrupts */
     uint32_t intrStatus = IC_GetInterruptState();
     IC_DisableInterrupts();
     
-    (dataBit & 0x01) ? SetBit(pinCode) : ClearBit(pinCode);
+    /* Core timer read itself */
+    startTick = _CP0_GET_COUNT();
+    readTicks = _CP0_GET_COUNT() - startTick;
+    
+    /* Pin access (bus idles as input, rewriting direction makes no edge) */
+    startTick = _CP0_GET_COUNT();
+    for (uint8_t idx = 0; idx < OW_CAL_LOOP_COUNT; idx++)
+    {
+        PIO_ConfigGpioPinDir(bus->pinCode, PIO_DIR_INPUT);
+    }
+    pioTicks = _CP0_GET_COUNT() - startTick - readTicks;
+    
+    /* Shortest delay */
+    startTick = _CP0_GET_COUNT();
+    for (uint8_t idx = 0; idx < OW_CAL_LOOP_COUNT; idx++)
+    {
+        TMR_DelayUs(1);
+    }
+    delayTicks = _CP0_GET_COUNT() - startTick - readTicks;
     
     /* Restore interrupt state */
     IC_SetInterruptState(intrStatus);
+    
+    delayNs = TicksToNs(delayTicks, sysFreq) / OW_CAL_LOOP_COUNT;
+    bus->overhead.pioNs = TicksToNs(pioTicks, sysFreq) / OW_CAL_LOOP_COUNT;
+    bus->overhead.delayNs = (delayNs > 1000) ? (delayNs - 1000) : 0;
+    
+    /* Re-apply delays of current speed mode */
+    OW_ConfigSpeedMode(bus, bus->speedMode);
+    
+    return true;
+}
+
+
+/*
+ *  Get protocol delays of currently configured speed mode
+ */
+extern const OwDelay_t *OW_GetDelay(const OwBus_t *bus)
+{
+    return &bus->delay;
+}
+
+
+/*
+ *  Record pull, release and sample events of bit-banged slots into ring
+ *  buffer "eventBuff" (trace NULL - recording off)
+ */
+extern bool OW_ConfigTrace(OwBus_t *bus, OwTrace_t *trace, OwTraceEvent_t *eventBuff, uint16_t eventCount)
+{
+    if (trace == NULL)
+    {
+        bus->trace = NULL;
+        return true;
+    }
+    
+    /* Inputs check */
+    if ((eventBuff == NULL) || (eventCount == 0))
+    {
+        return false;
+    }
+    
+    *trace = (OwTrace_t){.event = eventBuff, .size = eventCount};
+    bus->trace = trace;
+    
+    return true;
+}
+
+
+/*
+ *  Get recorded event by age (0 - oldest), NULL if out of range
+ */
+extern const OwTraceEvent_t *OW_GetTraceEvent(const OwTrace_t *trace, uint16_t eventIdx)
+{
+    if (eventIdx >= trace->count)
+    {
+        return NULL;
+    }
+    
+    return &trace->event[(trace->headIdx + trace->size - trace->count + eventIdx) % trace->size];
+}
+
+
+/*
+ *  Clear bus counters (bus-busy and masked time restart from 0)
+ */
+extern void OW_ResetStats(OwBus_t *bus)
+{
+    bus->stats = (OwStats_t){0};
+}
+
+
+/*
+ *  Reset the OW bus and return presence detected (on all buses of pin group)
+ */
+extern bool OW_Reset(OwBus_t *bus)
+{
+    return (OW_MultiReset(bus) == BUS_PIN_MASK(bus->pinCode));
+}
+
+
+/*
+ *  Write one bit (used primarily for ROM search)
+ */
+extern void OW_WriteBit(OwBus_t *bus, const uint8_t dataBit)
+{
+    uint32_t startTick = _CP0_GET_COUNT();
+    uint8_t dataByte = dataBit;
+    
+    if (bus->transport != NULL)
+    {
+        TransportTransfer(bus, &dataByte, 1, false);
+    }
+    else if (bus->maxMaskedUs != 0)
+    {
+        TransferBounded(bus, &dataByte, 1, false);
+    }
+    else
+    {
+        /* Obtain old interrupt status and disable interrupts */
+        uint32_t intrStatus = IC_GetInterruptState();
+        IC_DisableInterrupts();
+        
+        (dataBit & 0x01) ? SetBit(bus) : ClearBit(bus);
+        
+        /* Restore interrupt state */
+        IC_SetInterruptState(intrStatus);
+        AddMaskedTime(bus, startTick);
+    }
+    
+    AddBusyTime(bus, startTick);
 }
 
 /*
  *  Read one bit (used primarily for conversion done check or ROM search)
  */
-extern uint8_t OW_ReadBit(const uint32_t pinCode)
+extern uint8_t OW_ReadBit(OwBus_t *bus)
 {
-    return ReadBit(pinCode);
+    uint32_t startTick = _CP0_GET_COUNT();
+    uint8_t dataByte;
+    
+    if (bus->transport != NULL)
+    {
+        TransportTransfer(bus, &dataByte, 1, true);
+    }
+    else if (bus->maxMaskedUs != 0)
+    {
+        TransferBounded(bus, &dataByte, 1, true);
+    }
+    else
+    {
+        dataByte = ReadBit(bus);
+    }
+    
+    AddBusyTime(bus, startTick);
+    
+    return dataByte;
 }
 
 
 /*
  *  Send one byte on the OW bus
  */
-extern void OW_WriteByte(const uint32_t pinCode, uint8_t dataByte)
+extern void OW_WriteByte(OwBus_t *bus, uint8_t dataByte)
 {
-    /* Obtain old interrupt status and disable interrupts */
+    OW_WriteMultiByte(bus, &dataByte, 1);
+}
+
+
+/*
+ *  Send one byte and enable strong pull-up right after its last slot without
+ *  an interrupt in between (parasite powered DS18B20 needs it within 10 us,
+ *  so the last slot's recovery time is spent with the pull-up enabled)
+ */
+extern void OW_WriteBytePullup(OwBus_t *bus, uint8_t dataByte)
+{
+    uint32_t startTick = _CP0_GET_COUNT();
     uint32_t intrStatus = IC_GetInterruptState();
     IC_DisableInterrupts();
     
-    for (uint8_t idx = 0; idx < 8; idx++)
+    /* Transport completes slots on its own (pull-up after its last frame) */
+    if (bus->transport != NULL)
+    {
+        OW_WriteMultiByte(bus, &dataByte, 1);
+        OW_SetPullup(bus, true);
+        
+        IC_SetInterruptState(intrStatus);
+        return;
+    }
+    
+    /* Bits 0-6 */
+    for (uint8_t idx = 0; idx < 7; idx++)
     {
-        ((dataByte >> idx) & 0x01) ? SetBit(pinCode) : ClearBit(pinCode);   // LSB first
+        ((dataByte >> idx) & 0x01) ? SetBit(bus) : ClearBit(bus);   // LSB first
     }
     
+    /* Bit 7 without recovery delay */
+    bus->stats.bitCount++;
+    PullLow(bus);
+    TMR_DelayUs((dataByte & 0x80) ? bus->delay.a : bus->delay.c);
+    Release(bus, bus->pinCode);
+    OW_SetPullup(bus, true);
+    
     /* Restore interrupt state */
     IC_SetInterruptState(intrStatus);
+    AddMaskedTime(bus, startTick);
+    AddBusyTime(bus, startTick);
+}
+
+
+/*
+ *  Enable/disable strong pull-up (bus must not be accessed while enabled)
+ */
+extern void OW_SetPullup(OwBus_t *bus, bool isEnabled)
+{
+    if (bus->pullupPinCode != 0)
+    {
+        (isEnabled != bus->isPullupActiveLow) ? PIO_SetPin(bus->pullupPinCode) : PIO_ClearPin(bus->pullupPinCode);
+    }
+    /* Bus pin push-pull HIGH, latch cleared again for LOW pulses */
+    else if (isEnabled)
+    {
+        PIO_SetPin(bus->pinCode);
+        PIO_ConfigGpioPinDir(bus->pinCode, PIO_DIR_OUTPUT);
+    }
+    else
+    {
+        PIO_ConfigGpioPinDir(bus->pinCode, PIO_DIR_INPUT);
+        PIO_ClearPin(bus->pinCode);
+    }
 }
 
 
 /*
  *  Send more bytes on the OW bus
  */
-extern void OW_WriteMultiByte(const uint32_t pinCode, void *dataPtr, uint8_t dataLen)
+extern void OW_WriteMultiByte(OwBus_t *bus, void *dataPtr, uint8_t dataLen)
 {
+    uint32_t startTick = _CP0_GET_COUNT();
     uint8_t *dataByte = dataPtr;
     
-    /* Obtain old interrupt status and disable interrupts */
-    uint32_t intrStatus = IC_GetInterruptState();
-    IC_DisableInterrupts();
-    
-    /* Send each byte */
-    while (dataLen--)
+    if (bus->transport != NULL)
     {
-        for (uint8_t idx = 0; idx < 8; idx++)
+        TransportTransfer(bus, dataByte, dataLen * 8, false);
+    }
+    else if (bus->maxMaskedUs != 0)
+    {
+        TransferBounded(bus, dataByte, dataLen * 8, false);
+    }
+    else
+    {
+        /* Obtain old interrupt status and disable interrupts */
+        uint32_t intrStatus = IC_GetInterruptState();
+        IC_DisableInterrupts();
+        
+        /* Send each byte */
+        while (dataLen--)
         {
-            ((*dataByte >> idx) & 0x01) ? SetBit(pinCode) : ClearBit(pinCode);   // LSB first
+            for (uint8_t idx = 0; idx < 8; idx++)
+            {
+                ((*dataByte >> idx) & 0x01) ? SetBit(bus) : ClearBit(bus);   // LSB first
+            }
+            dataByte++;
         }
-        dataByte++;
+        
+        /* Restore interrupt state */
+        IC_SetInterruptState(intrStatus);
+        AddMaskedTime(bus, startTick);
     }
     
-    /* Restore interrupt state */
-    IC_SetInterruptState(intrStatus);
+    AddBusyTime(bus, startTick);
 }
 
 
 /*
  *  Read one byte on the OW bus
  */
-extern void OW_ReadByte(const uint32_t pinCode, void *dataPtr)
+extern void OW_ReadByte(OwBus_t *bus, void *dataPtr)
+{
+    OW_ReadMultiByte(bus, dataPtr, 1);
+}
+
+
+/*
+ *  Read more bytes on the OW bus
+ */
+extern void OW_ReadMultiByte(OwBus_t *bus, void *dataPtr, uint8_t dataLen)
 {
+    uint32_t startTick = _CP0_GET_COUNT();
     uint8_t *dataByte = dataPtr;
     
-    /* Obtain old interrupt status and disable interrupts */
-    uint32_t intrStatus = IC_GetInterruptState();
-    IC_DisableInterrupts();
-    
     /* Skip if pointer not initialized */
-    if (dataByte != NULL)
+    if (dataByte == NULL)
+    {
+        return;
+    }
+    
+    if (bus->transport != NULL)
+    {
+        TransportTransfer(bus, dataByte, dataLen * 8, true);
+    }
+    else if (bus->maxMaskedUs != 0)
+    {
+        TransferBounded(bus, dataByte, dataLen * 8, true);
+    }
+    else
     {
-        *dataByte = 0x00;
-        for (uint8_t idx = 0; idx < 8; idx++)
+        /* Obtain old interrupt status and disable interrupts */
+        uint32_t intrStatus = IC_GetInterruptState();
+        IC_DisableInterrupts();
+        
+        while (dataLen--)
         {
-            *dataByte |= (ReadBit(pinCode) << idx);   // LSB first
+            *dataByte = 0x00;
+            for (uint8_t idx = 0; idx < 8; idx++)
+            {
+                *dataByte |= (ReadBit(bus) << idx);   // LSB first
+            }
+            dataByte++;
         }
+        
+        /* Restore interrupt state */
+        IC_SetInterruptState(intrStatus);
+        AddMaskedTime(bus, startTick);
     }
     
-    /* Restore interrupt state */
-    IC_SetInterruptState(intrStatus);
+    AddBusyTime(bus, startTick);
 }
 
 
 /*
- *  Read more bytes on the OW bus
+ *  Read multiple bytes and pass each to "byteHook" as soon as it arrives
+ *  (e.g. running CRC), returns false if hook aborted the read
  */
-extern void OW_ReadMultiByte(const uint32_t pinCode, void *dataPtr, uint8_t dataLen)
+extern bool OW_ReadMultiByteHook(OwBus_t *bus, void *dataPtr, uint8_t dataLen, OwByteHook_t byteHook, void *context)
 {
+    uint32_t startTick = _CP0_GET_COUNT();
     uint8_t *dataByte = dataPtr;
+    bool isOk = true;
     
-    /* Obtain old interrupt status and disable interrupts */
-    uint32_t intrStatus = IC_GetInterruptState();
-    IC_DisableInterrupts();
+    /* Inputs check */
+    if ((dataByte == NULL) || (byteHook == NULL))
+    {
+        return false;
+    }
     
-    /* Skip if pointer not initialized */
-    if (dataByte != NULL)
+    /* Hook runs with interrupts enabled between bytes */
+    if ((bus->transport != NULL) || (bus->maxMaskedUs != 0))
     {
-        while (dataLen--)
+        for (uint8_t byteIdx = 0; (byteIdx < dataLen) && isOk; byteIdx++)
         {
-            *dataByte = 0x00;
+            if (bus->transport != NULL)
+            {
+                TransportTransfer(bus, &dataByte[byteIdx], 8, true);
+            }
+            else
+            {
+                TransferBounded(bus, &dataByte[byteIdx], 8, true);
+            }
+            isOk = byteHook(context, dataByte[byteIdx]);
+        }
+    }
+    else
+    {
+        /* Obtain old interrupt status and disable interrupts */
+        uint32_t intrStatus = IC_GetInterruptState();
+        IC_DisableInterrupts();
+        
+        for (uint8_t byteIdx = 0; (byteIdx < dataLen) && isOk; byteIdx++)
+        {
+            dataByte[byteIdx] = 0x00;
             for (uint8_t idx = 0; idx < 8; idx++)
             {
-                *dataByte |= (ReadBit(pinCode) << idx);   // LSB first
+                dataByte[byteIdx] |= (ReadBit(bus) << idx);   // LSB first
             }
-            dataByte++;
+            
+            /* Process byte before next slot (only extends recovery time) */
+            isOk = byteHook(context, dataByte[byteIdx]);
         }
+        
+        /* Restore interrupt state */
+        IC_SetInterruptState(intrStatus);
+        AddMaskedTime(bus, startTick);
     }
     
-    /* Restore interrupt state */
-    IC_SetInterruptState(intrStatus);
+    AddBusyTime(bus, startTick);
+    
+    return isOk;
+}
+
+/*
+ *  Reset all buses of pin group at once and return pin mask of buses with
+ *  presence detected
+ */
+extern uint32_t OW_MultiReset(OwBus_t *bus)
+{
+    uint32_t startTick = _CP0_GET_COUNT();
+    uint32_t pinLevel;
+    
+    if (bus->transport != NULL)
+    {
+        pinLevel = TransportReset(bus);
+    }
+    else
+    {
+        pinLevel = (bus->maxMaskedUs != 0) ? ResetBounded(bus) : Reset(bus);
+    }
+    
+    if (pinLevel != 0)
+    {
+        bus->stats.presenceFailCount++;
+    }
+    
+    AddBusyTime(bus, startTick);
+    
+    return BUS_PIN_MASK(bus->pinCode) & ~pinLevel;
+}
+
+
+/*
+ *  Send different bytes to each bus of pin group in lockstep (data of bus
+ *  "n" - n-th pin of group from LSB - starts at dataPtr + n * dataLen)
+ */
+extern void OW_MultiWriteMultiByte(OwBus_t *bus, const void *dataPtr, uint8_t dataLen)
+{
+    uint32_t startTick = _CP0_GET_COUNT();
+    
+    /* Input check */
+    if (dataPtr == NULL)
+    {
+        return;
+    }
+    
+    /* Transport backends drive a single bus */
+    if (bus->transport != NULL)
+    {
+        TransportTransfer(bus, (uint8_t *)dataPtr, dataLen * 8, false);
+    }
+    else
+    {
+        TransferMulti(bus, (uint8_t *)dataPtr, dataLen, false);
+    }
+    
+    AddBusyTime(bus, startTick);
+}
+
+
+/*
+ *  Read bytes from each bus of pin group in lockstep (same layout as
+ *  OW_MultiWriteMultiByte)
+ */
+extern void OW_MultiReadMultiByte(OwBus_t *bus, void *dataPtr, uint8_t dataLen)
+{
+    uint32_t startTick = _CP0_GET_COUNT();
+    
+    /* Input check */
+    if (dataPtr == NULL)
+    {
+        return;
+    }
+    
+    /* Transport backends drive a single bus */
+    if (bus->transport != NULL)
+    {
+        TransportTransfer(bus, dataPtr, dataLen * 8, true);
+    }
+    else
+    {
+        TransferMulti(bus, dataPtr, dataLen, true);
+    }
+    
+    AddBusyTime(bus, startTick);
 }
 
 /******************************************************************************/
@@ -242,65 +698,472 @@ extern void OW_ReadMultiByte(const uint32_t pinCode, void *dataPtr, uint8_t data
 /*
  *  Generate a single HIGH state on the OW bus
  */
-static INLINE void SetBit(const uint32_t pinCode)
+static INLINE void SetBit(OwBus_t *bus)
 {
-    PIO_ClearPin(pinCode);
-    PIO_ConfigGpioPinDir(pinCode, PIO_DIR_OUTPUT);
-    TMR_DelayUs(owDelay.a);
-    PIO_ConfigGpioPinDir(pinCode, PIO_DIR_INPUT);
-    TMR_DelayUs(owDelay.b);
+    bus->stats.bitCount++;
+    
+    PullLow(bus);
+    TMR_DelayUs(bus->delay.a);
+    Release(bus, bus->pinCode);
+    TMR_DelayUs(bus->delay.b);
 }
 
 
 /*
  *  Generate a single LOW state on the OW bus
  */
-static INLINE void ClearBit(const uint32_t pinCode)
+static INLINE void ClearBit(OwBus_t *bus)
 {
-    PIO_ClearPin(pinCode);
-    PIO_ConfigGpioPinDir(pinCode, PIO_DIR_OUTPUT);
-    TMR_DelayUs(owDelay.c);
-    PIO_ConfigGpioPinDir(pinCode, PIO_DIR_INPUT);
-    TMR_DelayUs(owDelay.d);
+    bus->stats.bitCount++;
+    
+    PullLow(bus);
+    TMR_DelayUs(bus->delay.c);
+    Release(bus, bus->pinCode);
+    TMR_DelayUs(bus->delay.d);
 }
 
 
 /*
  *  Read a single bit on the OW bus
  */
-static INLINE uint8_t ReadBit(const uint32_t pinCode)
+static INLINE uint8_t ReadBit(OwBus_t *bus)
 {
-    PIO_ClearPin(pinCode);
-    PIO_ConfigGpioPinDir(pinCode, PIO_DIR_OUTPUT);
-    TMR_DelayUs(owDelay.a);
-    PIO_ConfigGpioPinDir(pinCode, PIO_DIR_INPUT);
-    TMR_DelayUs(owDelay.e);
-    uint8_t bitVal = PIO_ReadPin(pinCode);
-    TMR_DelayUs(owDelay.f);
+    bus->stats.bitCount++;
+    
+    PullLow(bus);
+    TMR_DelayUs(bus->delay.a);
+    Release(bus, bus->pinCode);
+    TMR_DelayUs(bus->delay.e);
+    uint8_t bitVal = ReadLevel(bus);
+    TMR_DelayUs(bus->delay.f);
     
     return bitVal;
 }
 
 
 /*
- *  Generate a reset sequence on the OW bus
+ *  Generate a reset sequence on the OW bus and return pin levels (0 - presence)
  */
-static INLINE uint8_t Reset(const uint32_t pinCode)
+static INLINE uint32_t Reset(OwBus_t *bus)
 {
+    bus->stats.resetCount++;
+    
     /* Obtain old interrupt status and disable interrupts */
     uint32_t intrStatus = IC_GetInterruptState();
     IC_DisableInterrupts();
+    uint32_t maskTick = _CP0_GET_COUNT();
+    
+    PullLow(bus);
+    TMR_DelayUs(bus->delay.h);
+    Release(bus, bus->pinCode);
+    TMR_DelayUs(bus->delay.i);
+    uint32_t pinLevel = ReadPins(bus);
+    TMR_DelayUs(bus->delay.j);
+    
+    /* Restore interrupt state */
+    IC_SetInterruptState(intrStatus);
+    AddMaskedTime(bus, maskTick);
     
-    PIO_ClearPin(pinCode);
-    PIO_ConfigGpioPinDir(pinCode, PIO_DIR_OUTPUT);
-    TMR_DelayUs(owDelay.h);
+    return pinLevel;
+}
+
+
+/*
+ *  Sample bus level (pin group reads HIGH only if all its buses are HIGH)
+ */
+static INLINE uint8_t ReadLevel(OwBus_t *bus)
+{
+    return (ReadPins(bus) == BUS_PIN_MASK(bus->pinCode)) ? 1 : 0;
+}
+
+
+/*
+ *  Drive all pins of bus LOW (slot or reset start)
+ */
+static INLINE void PullLow(OwBus_t *bus)
+{
+    PIO_ClearPin(bus->pinCode);
+    PIO_ConfigGpioPinDir(bus->pinCode, PIO_DIR_OUTPUT);
+    Trace(bus, OW_TRACE_PULL, BUS_PIN_MASK(bus->pinCode));
+}
+
+
+/*
+ *  Release given pins of bus (external pull-up takes over)
+ */
+static INLINE void Release(OwBus_t *bus, const uint32_t pinCode)
+{
     PIO_ConfigGpioPinDir(pinCode, PIO_DIR_INPUT);
-    TMR_DelayUs(owDelay.i);
-    uint8_t bitVal = PIO_ReadPin(pinCode);
-    TMR_DelayUs(owDelay.j);
+    Trace(bus, OW_TRACE_RELEASE, BUS_PIN_MASK(pinCode));
+}
+
+
+/*
+ *  Read levels of all pins of bus
+ */
+static INLINE uint32_t ReadPins(OwBus_t *bus)
+{
+#if OW_MULTI_BUS
+    uint32_t pinLevel = PIO_ReadPort(bus->pinCode);
+#else
+    uint32_t pinLevel = PIO_ReadPin(bus->pinCode);
+#endif
+    
+    Trace(bus, OW_TRACE_SAMPLE, pinLevel);
+    
+    return pinLevel;
+}
+
+
+/*
+ *  Transfer bits with interrupts masked only where slot timing is critical
+ *  (LOW time of write slots, LOW time and sampling of read slots)
+ */
+static void TransferBounded(OwBus_t *bus, uint8_t *dataByte, uint16_t bitCount, bool isRead)
+{
+    /* Longest timing-critical part of any slot */
+    uint16_t critMaxUs = ((bus->delay.a + bus->delay.e) > bus->delay.c) ? (bus->delay.a + bus->delay.e) : bus->delay.c;
+    uint16_t critUs, recUs, maskedUs = 0;
+    uint32_t maskTick = 0;
+    uint8_t dataBit, bitPos;
+    bool isMasked = false;
+    
+    bus->stats.bitCount += bitCount;
+    
+    /* Obtain old interrupt status */
+    uint32_t intrStatus = IC_GetInterruptState();
+    
+    for (uint16_t bitIdx = 0; bitIdx < bitCount; bitIdx++)
+    {
+        bitPos = bitIdx % 8;
+        
+        /* Open new masked window at start of slot */
+        if (!isMasked)
+        {
+            IC_DisableInterrupts();
+            maskTick = _CP0_GET_COUNT();
+            isMasked = true;
+            maskedUs = 0;
+        }
+        
+        if (isRead)
+        {
+            if (bitPos == 0)
+            {
+                dataByte[bitIdx / 8] = 0x00;
+            }
+            
+            PullLow(bus);
+            TMR_DelayUs(bus->delay.a);
+            Release(bus, bus->pinCode);
+            TMR_DelayUs(bus->delay.e);
+            dataByte[bitIdx / 8] |= (ReadLevel(bus) << bitPos);   // LSB first
+            
+            critUs = bus->delay.a + bus->delay.e;
+            recUs = bus->delay.f;
+        }
+        else
+        {
+            dataBit = (dataByte[bitIdx / 8] >> bitPos) & 0x01;  // LSB first
+            critUs = dataBit ? bus->delay.a : bus->delay.c;
+            recUs = dataBit ? bus->delay.b : bus->delay.d;
+            
+            PullLow(bus);
+            TMR_DelayUs(critUs);
+            Release(bus, bus->pinCode);
+        }
+        maskedUs += critUs + 1;     // 1 us margin for PIO access overhead
+        
+        /* Unmask during recovery unless next slot still fits into window */
+        if ((maskedUs + recUs + critMaxUs) > bus->maxMaskedUs)
+        {
+            IC_SetInterruptState(intrStatus);
+            AddMaskedTime(bus, maskTick);
+            isMasked = false;
+        }
+        else
+        {
+            maskedUs += recUs;
+        }
+        
+        TMR_DelayUs(recUs);
+    }
+    
+    /* Restore interrupt state */
+    if (isMasked)
+    {
+        IC_SetInterruptState(intrStatus);
+        AddMaskedTime(bus, maskTick);
+    }
+}
+
+
+/*
+ *  Generate a reset sequence with interrupts masked only around presence
+ *  sampling (standard-speed reset LOW time has no upper bound that matters,
+ *  shorter resets are kept masked as stretching them changes their meaning)
+ */
+static uint32_t ResetBounded(OwBus_t *bus)
+{
+    bus->stats.resetCount++;
+    
+    /* Obtain old interrupt status */
+    uint32_t intrStatus = IC_GetInterruptState();
+    bool isStretchable = (bus->speedMode == OW_STANDARD_SPEED);
+    uint32_t maskTick = 0;
+    
+    if (!isStretchable)
+    {
+        IC_DisableInterrupts();
+        maskTick = _CP0_GET_COUNT();
+    }
+    
+    PullLow(bus);
+    TMR_DelayUs(bus->delay.h);
+    
+    if (isStretchable)
+    {
+        IC_DisableInterrupts();
+        maskTick = _CP0_GET_COUNT();
+    }
+    Release(bus, bus->pinCode);
+    TMR_DelayUs(bus->delay.i);
+    uint32_t pinLevel = ReadPins(bus);
     
     /* Restore interrupt state */
     IC_SetInterruptState(intrStatus);
+    AddMaskedTime(bus, maskTick);
+    TMR_DelayUs(bus->delay.j);
     
-    return bitVal;
-}
\ No newline at end of file
+    return pinLevel;
+}
+
+
+/*
+ *  Record slot event if bus is traced
+ */
+static INLINE void Trace(OwBus_t *bus, OwTraceType_t type, uint32_t pinMask)
+{
+    if (bus->trace != NULL)
+    {
+        TraceEvent(bus->trace, type, pinMask);
+    }
+}
+
+
+/*
+ *  Store event with core timer timestamp, overwrite oldest if buffer full
+ */
+static void TraceEvent(OwTrace_t *trace, OwTraceType_t type, uint32_t pinMask)
+{
+    OwTraceEvent_t *event = &trace->event[trace->headIdx];
+    
+    event->tick = _CP0_GET_COUNT();
+    event->pinMask = pinMask;
+    event->type = type;
+    
+    trace->headIdx = (trace->headIdx + 1) % trace->size;
+    if (trace->count < trace->size)
+    {
+        trace->count++;
+    }
+    else
+    {
+        trace->lostCount++;
+    }
+}
+
+
+/*
+ *  Accumulate core timer ticks spent in a transfer
+ */
+static INLINE void AddBusyTime(OwBus_t *bus, uint32_t startTick)
+{
+    bus->stats.busyTicks += _CP0_GET_COUNT() - startTick;
+}
+
+
+/*
+ *  Track longest interrupt-masked window (started at "startTick")
+ */
+static INLINE void AddMaskedTime(OwBus_t *bus, uint32_t startTick)
+{
+    uint32_t maskedTicks = _CP0_GET_COUNT() - startTick;
+    
+    if (maskedTicks > bus->stats.maxMaskedTicks)
+    {
+        bus->stats.maxMaskedTicks = maskedTicks;
+    }
+}
+
+
+/*
+ *  Shorten delays by call overhead adding to them - every delay ends with
+ *  a pin access (release or sample), recovery delays also include both pin
+ *  accesses of the next slot's falling edge
+ */
+static void CompensateDelay(OwBus_t *bus)
+{
+    uint32_t edgeNs = bus->overhead.delayNs + bus->overhead.pioNs;
+    uint32_t slotNs = edgeNs + bus->overhead.pioNs;
+    
+    bus->delay.a = SubOverhead(bus->delay.a, edgeNs);
+    bus->delay.b = SubOverhead(bus->delay.b, slotNs);
+    bus->delay.c = SubOverhead(bus->delay.c, edgeNs);
+    bus->delay.d = SubOverhead(bus->delay.d, slotNs);
+    bus->delay.e = SubOverhead(bus->delay.e, edgeNs);
+    bus->delay.f = SubOverhead(bus->delay.f, slotNs);
+    bus->delay.h = SubOverhead(bus->delay.h, edgeNs);
+    bus->delay.i = SubOverhead(bus->delay.i, edgeNs);
+    bus->delay.j = SubOverhead(bus->delay.j, slotNs);
+}
+
+
+/*
+ *  Subtract overhead rounded to delay resolution (1 us), saturate at 0
+ */
+static INLINE uint16_t SubOverhead(uint16_t delayUs, uint32_t overheadNs)
+{
+    uint32_t overheadUs = (overheadNs + 500) / 1000;
+    
+    return (delayUs > overheadUs) ? (delayUs - overheadUs) : 0;
+}
+
+
+/*
+ *  Convert core timer ticks (SYSCLK/2) to nanoseconds
+ */
+static INLINE uint32_t TicksToNs(uint32_t coreTicks, uint32_t sysFreq)
+{
+    return (uint32_t)(((uint64_t)coreTicks * 2000000000) / sysFreq);
+}
+
+
+/*
+ *  Generate a reset sequence with transport backend and return pin levels
+ *  (0 - presence)
+ */
+static uint32_t TransportReset(OwBus_t *bus)
+{
+    bus->stats.resetCount++;
+    
+    return bus->transport->reset(bus->transportCtx) ? 0 : BUS_PIN_MASK(bus->pinCode);
+}
+
+
+/*
+ *  Transfer bits with transport backend
+ */
+static void TransportTransfer(OwBus_t *bus, uint8_t *dataByte, uint16_t bitCount, bool isRead)
+{
+    bus->stats.bitCount += bitCount;
+    
+    bus->transport->transfer(bus->transportCtx, dataByte, bitCount, isRead);
+}
+
+
+/*
+ *  Transfer bytes on all buses of pin group with one port access per slot
+ *  edge - write slots pull all buses LOW, release buses sending one after
+ *  "a" and the rest after "c", read slots sample all buses with one read
+ *  (latency-bounded mode masks only the timing-critical part of each slot)
+ */
+static void TransferMulti(OwBus_t *bus, uint8_t *dataBuff, uint8_t dataLen, bool isRead)
+{
+    uint32_t busPin[OW_MAX_BUS_COUNT];
+    uint32_t pinMask = BUS_PIN_MASK(bus->pinCode);
+    uint32_t pinLevel, oneMask;
+    uint8_t busCount = 0;
+    uint8_t *dataByte;
+    
+    /* Write one recovery is met if ones are released with zeros' recovery */
+    uint16_t recUs = isRead ? bus->delay.f : (((bus->delay.a + bus->delay.b) > (bus->delay.c + bus->delay.d)) ?
+                                           (bus->delay.a + bus->delay.b - bus->delay.c) : bus->delay.d);
+    
+    /* Pin of each bus (LSB first) */
+    for (uint32_t pinBit = 1; (pinBit <= pinMask) && (pinBit != 0); pinBit <<= 1)
+    {
+        if (pinMask & pinBit)
+        {
+            busPin[busCount++] = pinBit;
+        }
+    }
+    
+    bus->stats.bitCount += dataLen * 8;
+    
+    /* Obtain old interrupt status and disable interrupts */
+    uint32_t intrStatus = IC_GetInterruptState();
+    IC_DisableInterrupts();
+    uint32_t maskTick = _CP0_GET_COUNT();
+    
+    for (uint8_t byteIdx = 0; byteIdx < dataLen; byteIdx++)
+    {
+        for (uint8_t bitPos = 0; bitPos < 8; bitPos++)
+        {
+            if (isRead)
+            {
+                PullLow(bus);
+                TMR_DelayUs(bus->delay.a);
+                Release(bus, bus->pinCode);
+                TMR_DelayUs(bus->delay.e);
+                pinLevel = ReadPins(bus);
+                
+                for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+                {
+                    dataByte = &dataBuff[busIdx * dataLen + byteIdx];
+                    *dataByte = (bitPos == 0) ? 0x00 : *dataByte;
+                    *dataByte |= ((pinLevel & busPin[busIdx]) ? 1 : 0) << bitPos;   // LSB first
+                }
+            }
+            else
+            {
+                oneMask = 0;
+                for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+                {
+                    oneMask |= ((dataBuff[busIdx * dataLen + byteIdx] >> bitPos) & 0x01) ? busPin[busIdx] : 0;
+                }
+                
+                PullLow(bus);
+                TMR_DelayUs(bus->delay.a);
+                if (oneMask != 0)
+                {
+                    Release(bus, SubGroup(bus->pinCode, oneMask));
+                }
+                TMR_DelayUs((bus->delay.c > bus->delay.a) ? (bus->delay.c - bus->delay.a) : 0);
+                Release(bus, bus->pinCode);
+            }
+            
+            /* Interrupts may be served during recovery */
+            if (bus->maxMaskedUs != 0)
+            {
+                IC_SetInterruptState(intrStatus);
+                AddMaskedTime(bus, maskTick);
+                TMR_DelayUs(recUs);
+                IC_DisableInterrupts();
+                maskTick = _CP0_GET_COUNT();
+            }
+            else
+            {
+                TMR_DelayUs(recUs);
+            }
+        }
+    }
+    
+    /* Restore interrupt state */
+    IC_SetInterruptState(intrStatus);
+    AddMaskedTime(bus, maskTick);
+}
+
+
+/*
+ *  Pin code of given pins on the port of pin group
+ */
+static INLINE uint32_t SubGroup(const uint32_t groupCode, uint32_t pinMask)
+{
+#if OW_MULTI_BUS
+    return (groupCode & ~PIO_PIN_MASK(groupCode)) | pinMask;
+#else
+    (void)pinMask;
+    return groupCode;
+#endif
+}
@@ -17,12 +17,28 @@
 /*---------------------------------Macros-------------------------------------*/
 /******************************************************************************/
 
+/** Pin groups - several buses driven in lockstep (needs PIO_ReadPort and PIO_PIN_MASK of GPIO layer) **/
+#ifndef OW_MULTI_BUS
+#define OW_MULTI_BUS        0
+#endif
 
+/** Max. buses driven in lockstep (pins of one GPIO port) **/
+#define OW_MAX_BUS_COUNT    16
+
+/** Calls averaged per overhead measurement of OW_CalibrateTiming **/
+#define OW_CAL_LOOP_COUNT   16
 
 /******************************************************************************/
 /*----------------------------Enumeration Types-------------------------------*/
 /******************************************************************************/
 
+/* OW trace event types */
+typedef enum {
+    OW_TRACE_PULL = 0,      // Pins driven LOW (slot or reset start)
+    OW_TRACE_RELEASE = 1,   // Pins released to pull-up
+    OW_TRACE_SAMPLE = 2     // Pin levels read
+} OwTraceType_t;
+
 /* OW speed flags */
 typedef enum {
     OW_STANDARD_SPEED = 0,  
@@ -41,19 +57,110 @@ typedef struct {
     OwSpeedMode_t   speedMode;
 } OwConfig_t;
 
+/* OW protocol delays in microseconds (see Maxim AN126 for a-j meaning) */
+typedef struct {
+    uint16_t a;     // Write 1 / read LOW time
+    uint16_t b;     // Write 1 recovery
+    uint16_t c;     // Write 0 LOW time
+    uint16_t d;     // Write 0 recovery
+    uint16_t e;     // Read sample delay
+    uint16_t f;     // Read recovery
+    uint16_t g;     // Reset pre-delay
+    uint16_t h;     // Reset LOW time
+    uint16_t i;     // Presence sample delay
+    uint16_t j;     // Reset recovery
+} OwDelay_t;
+
+/* CPU overhead of slot generation calls (measured by OW_CalibrateTiming) */
+typedef struct {
+    uint16_t        pioNs;          // Per PIO_* call
+    uint16_t        delayNs;        // Per TMR_DelayUs call beyond requested time
+} OwOverhead_t;
+
+/* Bus counters (accumulated since OW_ConfigBus or OW_ResetStats) */
+typedef struct {
+    uint32_t        resetCount;
+    uint32_t        presenceFailCount;
+    uint32_t        bitCount;       // Read/write slots
+    uint64_t        busyTicks;      // Core timer ticks spent in OW_* transfers
+    uint32_t        maxMaskedTicks; // Longest interrupt-masked window (core timer ticks)
+} OwStats_t;
+
+/* Trace event of bit-banged slot */
+typedef struct {
+    uint32_t        tick;           // Core timer (SYSCLK/2)
+    uint32_t        pinMask;        // Pins pulled/released or pin levels read
+    OwTraceType_t   type;
+} OwTraceEvent_t;
+
+/* Trace ring buffer (oldest events overwritten when full, owned by caller) */
+typedef struct {
+    OwTraceEvent_t  *event;
+    uint16_t        size;
+    uint16_t        headIdx;        // Next event written
+    uint16_t        count;          // Stored events
+    uint32_t        lostCount;      // Overwritten events
+} OwTrace_t;
+
+/* Slot generation backend replacing bit-banging (e.g. OneWireUart.h) */
+/* Functions get the context passed to OW_ConfigTransport */
+typedef struct {
+    void (*configSpeed)(void *context, OwSpeedMode_t speedMode);
+    bool (*reset)(void *context);                                               // Returns presence
+    void (*transfer)(void *context, uint8_t *dataBuff, uint16_t bitCount, bool isRead);    // LSB first
+} OwTransport_t;
+
+/* OW bus context (one per bus or pin group, owned by caller) */
+typedef struct {
+    uint32_t        pinCode;        // Pin or pin group
+    OwSpeedMode_t   speedMode;
+    OwDelay_t       delay;          // Slot delays of speed mode (overhead compensated)
+    OwOverhead_t    overhead;       // Compensated call overhead (0 - datasheet delays)
+    uint16_t        maxMaskedUs;    // Latency-bounded masking window (0 - off)
+    OwStats_t       stats;
+    const OwTransport_t *transport; // NULL - slots bit-banged on pinCode
+    void            *transportCtx;
+    OwTrace_t       *trace;         // Slot event recorder (NULL - off)
+    uint32_t        pullupPinCode;  // Strong pull-up switch (0 - bus pin driven HIGH)
+    bool            isPullupActiveLow; // Switch enabled at LOW level (e.g. P-MOSFET gate)
+} OwBus_t;
+
+/* Received byte hook (runs in recovery gap after each byte, keep it short) */
+/* Returning false aborts the read - bus must be reset before next access */
+typedef bool (*OwByteHook_t)(void *context, uint8_t dataByte);
+
+
 /******************************************************************************/
 /*---------------------------- Function Prototypes----------------------------*/
 /******************************************************************************/
 
-bool OW_ConfigBus(OwConfig_t owConfig);
-void OW_ConfigSpeedMode(OwSpeedMode_t speedMode);
-bool OW_Reset(const uint32_t pinCode);
-void OW_WriteBit(const uint32_t pinCode, const uint8_t dataBit);
-uint8_t OW_ReadBit(const uint32_t pinCode);
-void OW_WriteByte(const uint32_t pinCode, uint8_t dataByte);
-void OW_ReadByte(const uint32_t pinCode, void *dataPtr);
-void OW_WriteMultiByte(const uint32_t pinCode, void *dataPtr, uint8_t dataLen);
-void OW_ReadMultiByte(const uint32_t pinCode, void *dataPtr, uint8_t dataLen);
+bool OW_ConfigBus(OwBus_t *bus, OwConfig_t owConfig);
+void OW_ConfigSpeedMode(OwBus_t *bus, OwSpeedMode_t speedMode);
+void OW_ConfigMaxMasked(OwBus_t *bus, uint16_t maxMaskedUs);
+void OW_ConfigTransport(OwBus_t *bus, const OwTransport_t *transport, void *context);
+void OW_ConfigPullup(OwBus_t *bus, const uint32_t pinCode, bool isActiveLow);
+bool OW_CalibrateTiming(OwBus_t *bus);
+bool OW_ConfigTrace(OwBus_t *bus, OwTrace_t *trace, OwTraceEvent_t *eventBuff, uint16_t eventCount);
+const OwTraceEvent_t *OW_GetTraceEvent(const OwTrace_t *trace, uint16_t eventIdx);
+const OwDelay_t *OW_GetDelay(const OwBus_t *bus);
+void OW_ResetStats(OwBus_t *bus);
+bool OW_Reset(OwBus_t *bus);
+void OW_WriteBit(OwBus_t *bus, const uint8_t dataBit);
+uint8_t OW_ReadBit(OwBus_t *bus);
+void OW_WriteByte(OwBus_t *bus, uint8_t dataByte);
+void OW_WriteBytePullup(OwBus_t *bus, uint8_t dataByte);
+void OW_SetPullup(OwBus_t *bus, bool isEnabled);
+void OW_ReadByte(OwBus_t *bus, void *dataPtr);
+void OW_WriteMultiByte(OwBus_t *bus, void *dataPtr, uint8_t dataLen);
+void OW_ReadMultiByte(OwBus_t *bus, void *dataPtr, uint8_t dataLen);
+bool OW_ReadMultiByteHook(OwBus_t *bus, void *dataPtr, uint8_t dataLen, OwByteHook_t byteHook, void *context);
+
+/** Multi-bus functions (bus pin code is a pin group - OR'ed pins of one port) **/
+/** Single-pin functions also accept pin groups (same data on all buses) **/
+uint8_t OW_GetBusCount(const OwBus_t *bus);
+uint32_t OW_MultiReset(OwBus_t *bus);
+void OW_MultiWriteMultiByte(OwBus_t *bus, const void *dataPtr, uint8_t dataLen);
+void OW_MultiReadMultiByte(OwBus_t *bus, void *dataPtr, uint8_t dataLen);
 
 
 #endif	/* ONEWIRE_H */
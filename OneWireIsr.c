@@ -0,0 +1,349 @@
+#include "OneWireIsr.h"
+
+/*
+ *  Timer-interrupt-driven OneWire transport
+ *
+ *  Each slot is split at its edges into phases. OW_IsrService() executes one
+ *  phase per call (from a timer/compare ISR) and re-arms the timer for the
+ *  remaining time of the slot, so the CPU is free between slot edges. Slot
+ *  timing and counters are taken from the OW bus context it serves.
+ */
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+/** Engine state (single timer - serves one bus at a time) **/
+static struct {
+    OwBus_t         *bus;
+    OwIsrTimer_t    armTimer;
+    OwIsrOp_t       queue[OW_ISR_QUEUE_SIZE];
+    uint8_t         headIdx;
+    uint8_t         opCount;
+    uint8_t         byteIdx;
+    uint8_t         bitIdx;
+    uint8_t         phase;
+    bool            isPresent;
+    volatile bool   isRunning;
+} isrVar;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static bool QueueOp(OwIsrOpType_t opType, uint8_t *dataPtr, uint8_t dataLen, OwIsrCallback_t callback, void *context);
+static uint32_t ResetPhase(void);
+static uint32_t WritePhase(OwIsrOp_t *op);
+static uint32_t ReadPhase(OwIsrOp_t *op);
+static INLINE uint32_t Wait(uint16_t delayUs);
+static INLINE void PullLow(void);
+static INLINE void Release(void);
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Configure ISR engine for given bit-banged bus (configured with OW_ConfigBus)
+ */
+extern bool OW_IsrConfig(OwBus_t *bus, OwIsrTimer_t armTimer)
+{
+    /* Inputs check */
+    if ((bus == NULL) || (armTimer == NULL) || (bus->transport != NULL) || isrVar.isRunning)
+    {
+        return false;
+    }
+
+    isrVar.bus = bus;
+    isrVar.armTimer = armTimer;
+    isrVar.headIdx = 0;
+    isrVar.opCount = 0;
+    isrVar.phase = 0;
+
+    return true;
+}
+
+
+/*
+ *  Queue reset sequence (callback gets presence)
+ */
+extern bool OW_IsrQueueReset(OwIsrCallback_t callback, void *context)
+{
+    return QueueOp(OW_ISR_OP_RESET, NULL, 0, callback, context);
+}
+
+
+/*
+ *  Queue bytes to send (LSB first)
+ */
+extern bool OW_IsrQueueWrite(const void *dataPtr, uint8_t dataLen, OwIsrCallback_t callback, void *context)
+{
+    if ((dataPtr == NULL) || (dataLen == 0))
+    {
+        return false;
+    }
+
+    return QueueOp(OW_ISR_OP_WRITE, (uint8_t *)dataPtr, dataLen, callback, context);
+}
+
+
+/*
+ *  Queue bytes to receive (LSB first)
+ */
+extern bool OW_IsrQueueRead(void *dataPtr, uint8_t dataLen, OwIsrCallback_t callback, void *context)
+{
+    if ((dataPtr == NULL) || (dataLen == 0))
+    {
+        return false;
+    }
+
+    return QueueOp(OW_ISR_OP_READ, dataPtr, dataLen, callback, context);
+}
+
+
+/*
+ *  Check if any queued operation is not finished yet
+ */
+extern bool OW_IsrIsBusy(void)
+{
+    return isrVar.isRunning;
+}
+
+
+/*
+ *  Execute next slot phase (call from timer ISR only)
+ */
+extern void OW_IsrService(void)
+{
+    uint32_t delayUs = 0;
+
+    while (isrVar.opCount > 0)
+    {
+        OwIsrOp_t *op = &isrVar.queue[isrVar.headIdx];
+
+        switch (op->opType)
+        {
+            case OW_ISR_OP_RESET:
+                delayUs = ResetPhase();
+                break;
+            case OW_ISR_OP_WRITE:
+                delayUs = WritePhase(op);
+                break;
+            case OW_ISR_OP_READ:
+            default:
+                delayUs = ReadPhase(op);
+                break;
+        }
+
+        /* Wait for next edge */
+        if (delayUs > 0)
+        {
+            break;
+        }
+
+        /* Operation done: pop it before callback so that it may queue more */
+        OwIsrCallback_t callback = op->callback;
+        void *context = op->context;
+        bool isOk = (op->opType == OW_ISR_OP_RESET) ? isrVar.isPresent : true;
+
+        isrVar.headIdx = (isrVar.headIdx + 1) % OW_ISR_QUEUE_SIZE;
+        isrVar.opCount--;
+        isrVar.byteIdx = 0;
+        isrVar.bitIdx = 0;
+        isrVar.phase = 0;
+
+        if (callback != NULL)
+        {
+            callback(context, isOk);
+        }
+    }
+
+    /* Queue empty - stop timer */
+    if (isrVar.opCount == 0)
+    {
+        isrVar.isRunning = false;
+    }
+
+    isrVar.armTimer(delayUs);
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Add operation to queue and start timer if engine is idle
+ */
+static bool QueueOp(OwIsrOpType_t opType, uint8_t *dataPtr, uint8_t dataLen, OwIsrCallback_t callback, void *context)
+{
+    if (isrVar.armTimer == NULL)
+    {
+        return false;
+    }
+
+    /* Obtain old interrupt status and disable interrupts */
+    uint32_t intrStatus = IC_GetInterruptState();
+    IC_DisableInterrupts();
+
+    if (isrVar.opCount >= OW_ISR_QUEUE_SIZE)
+    {
+        IC_SetInterruptState(intrStatus);
+        return false;
+    }
+
+    OwIsrOp_t *op = &isrVar.queue[(isrVar.headIdx + isrVar.opCount) % OW_ISR_QUEUE_SIZE];
+    op->opType = opType;
+    op->dataPtr = dataPtr;
+    op->dataLen = dataLen;
+    op->callback = callback;
+    op->context = context;
+    isrVar.opCount++;
+
+    /* Kick off timer (callbacks queuing from ISR find engine running) */
+    bool isStart = !isrVar.isRunning;
+    isrVar.isRunning = true;
+
+    /* Restore interrupt state */
+    IC_SetInterruptState(intrStatus);
+
+    if (isStart)
+    {
+        isrVar.armTimer(1);
+    }
+
+    return true;
+}
+
+
+/*
+ *  Reset: LOW for "h", release, sample presence after "i", recover for "j"
+ */
+static uint32_t ResetPhase(void)
+{
+    const OwDelay_t *owDelay = OW_GetDelay(isrVar.bus);
+
+    switch (isrVar.phase++)
+    {
+        case 0:
+            isrVar.bus->stats.resetCount++;
+            PullLow();
+            return Wait(owDelay->h);
+        case 1:
+            Release();
+            return Wait(owDelay->i);
+        case 2:
+            isrVar.isPresent = !PIO_ReadPin(isrVar.bus->pinCode);
+            isrVar.bus->stats.presenceFailCount += isrVar.isPresent ? 0 : 1;
+            return Wait(owDelay->j);
+        default:
+            return 0;
+    }
+}
+
+
+/*
+ *  Write slot: LOW for "a" (one) or "c" (zero), then recover for "b" or "d"
+ */
+static uint32_t WritePhase(OwIsrOp_t *op)
+{
+    const OwDelay_t *owDelay = OW_GetDelay(isrVar.bus);
+
+    /* All bits sent */
+    if (isrVar.byteIdx >= op->dataLen)
+    {
+        return 0;
+    }
+
+    uint8_t dataBit = (op->dataPtr[isrVar.byteIdx] >> isrVar.bitIdx) & 0x01;
+
+    if (isrVar.phase == 0)
+    {
+        isrVar.bus->stats.bitCount++;
+        PullLow();
+        isrVar.phase = 1;
+        return Wait(dataBit ? owDelay->a : owDelay->c);
+    }
+
+    Release();
+    isrVar.phase = 0;
+
+    /* Next bit (LSB first) */
+    if (++isrVar.bitIdx == 8)
+    {
+        isrVar.bitIdx = 0;
+        isrVar.byteIdx++;
+    }
+
+    return Wait(dataBit ? owDelay->b : owDelay->d);
+}
+
+
+/*
+ *  Read slot: LOW for "a", release, sample after "e", recover for "f"
+ */
+static uint32_t ReadPhase(OwIsrOp_t *op)
+{
+    const OwDelay_t *owDelay = OW_GetDelay(isrVar.bus);
+
+    /* All bits received */
+    if (isrVar.byteIdx >= op->dataLen)
+    {
+        return 0;
+    }
+
+    switch (isrVar.phase)
+    {
+        case 0:
+            if (isrVar.bitIdx == 0)
+            {
+                op->dataPtr[isrVar.byteIdx] = 0x00;
+            }
+            isrVar.bus->stats.bitCount++;
+            PullLow();
+            isrVar.phase = 1;
+            return Wait(owDelay->a);
+        case 1:
+            Release();
+            isrVar.phase = 2;
+            return Wait(owDelay->e);
+        default:
+            op->dataPtr[isrVar.byteIdx] |= (PIO_ReadPin(isrVar.bus->pinCode) << isrVar.bitIdx);
+            isrVar.phase = 0;
+
+            /* Next bit (LSB first) */
+            if (++isrVar.bitIdx == 8)
+            {
+                isrVar.bitIdx = 0;
+                isrVar.byteIdx++;
+            }
+            return Wait(owDelay->f);
+    }
+}
+
+
+/*
+ *  Delay until next edge (zero is reserved for "operation done")
+ */
+static INLINE uint32_t Wait(uint16_t delayUs)
+{
+    return (delayUs > 0) ? delayUs : 1;
+}
+
+
+/*
+ *  Drive bus LOW
+ */
+static INLINE void PullLow(void)
+{
+    PIO_ClearPin(isrVar.bus->pinCode);
+    PIO_ConfigGpioPinDir(isrVar.bus->pinCode, PIO_DIR_OUTPUT);
+}
+
+
+/*
+ *  Release bus (external pull-up sets it HIGH)
+ */
+static INLINE void Release(void)
+{
+    PIO_ConfigGpioPinDir(isrVar.bus->pinCode, PIO_DIR_INPUT);
+}
@@ -0,0 +1,60 @@
+#ifndef ONEWIREISR_H
+#define	ONEWIREISR_H
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "OneWire.h"
+
+/******************************************************************************/
+/*---------------------------------Macros-------------------------------------*/
+/******************************************************************************/
+
+/** Max. amount of queued operations (reset, write or read) **/
+#define OW_ISR_QUEUE_SIZE       8
+
+/******************************************************************************/
+/*----------------------------Enumeration Types-------------------------------*/
+/******************************************************************************/
+
+/* Queued operation type */
+typedef enum {
+    OW_ISR_OP_RESET = 0,
+    OW_ISR_OP_WRITE = 1,
+    OW_ISR_OP_READ = 2
+} OwIsrOpType_t;
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Completion callback (runs in timer ISR context, may queue new operations) */
+/* "isOk" holds presence for reset and is always true for write and read */
+typedef void (*OwIsrCallback_t)(void *context, bool isOk);
+
+/* Timer (re-)arm hook: next OW_IsrService() call in "delayUs", 0 stops timer */
+typedef void (*OwIsrTimer_t)(uint32_t delayUs);
+
+/* Queued operation */
+typedef struct {
+    OwIsrOpType_t   opType;
+    uint8_t         *dataPtr;   // Must stay valid until callback
+    uint8_t         dataLen;
+    OwIsrCallback_t callback;
+    void            *context;
+} OwIsrOp_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool OW_IsrConfig(OwBus_t *bus, OwIsrTimer_t armTimer);
+bool OW_IsrQueueReset(OwIsrCallback_t callback, void *context);
+bool OW_IsrQueueWrite(const void *dataPtr, uint8_t dataLen, OwIsrCallback_t callback, void *context);
+bool OW_IsrQueueRead(void *dataPtr, uint8_t dataLen, OwIsrCallback_t callback, void *context);
+bool OW_IsrIsBusy(void);
+void OW_IsrService(void);
+
+#endif	/* ONEWIREISR_H */
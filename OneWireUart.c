@@ -0,0 +1,152 @@
+#include "OneWireUart.h"
+
+/*
+ *  UART-driven OneWire transport
+ *
+ *  Every slot is one UART byte sent at the slot baud rate: 0xFF holds the line
+ *  LOW for the start bit only (write one / read slot), 0x00 for start and all
+ *  data bits (write zero). RX sees the wired-AND line, so a read slot returns
+ *  0xFF only if no device pulled the line LOW. A reset is one byte at a lower
+ *  baud rate whose LOW bits form the reset pulse, devices' presence pulse
+ *  corrupts its HIGH bits. Slot timing is generated by the UART hardware.
+ */
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+/** UART frames of speed mode **/
+typedef struct {
+    uint32_t    resetBaud;
+    uint8_t     resetByte;      // Start bit + LOW data bits form reset pulse
+    uint32_t    slotBaud;
+} UartTiming_t;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void UartConfigSpeed(void *context, OwSpeedMode_t speedMode);
+static bool UartReset(void *context);
+static void UartTransfer(void *context, uint8_t *dataBuff, uint16_t bitCount, bool isRead);
+static INLINE void SetBaud(OwUart_t *uart, uint32_t baudRate);
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const UartTiming_t uartTiming[] = {
+    [OW_STANDARD_SPEED] = {9600, 0xF0, 115200},     // 521 us reset, 78 us write zero
+    [OW_HIGH_SPEED] = {19200, 0xF0, 230400},        // 260 us reset, 39 us write zero
+    [OW_OVERLOAD_SPEED] = {115200, 0x80, 1000000}   // 69 us reset, 9 us write zero
+};
+
+static const OwTransport_t uartTransport = {
+    .configSpeed = UartConfigSpeed,
+    .reset = UartReset,
+    .transfer = UartTransfer
+};
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Hand slot generation of bus (configured with OW_ConfigBus) over to UART
+ */
+extern bool OW_UartConfig(OwBus_t *bus, OwUart_t *uart, OwUartPort_t port)
+{
+    /* Inputs check */
+    if ((bus == NULL) || (uart == NULL) || (port.setBaud == NULL) || (port.exchange == NULL))
+    {
+        return false;
+    }
+
+    uart->port = port;
+    uart->baudRate = 0;
+
+    OW_ConfigTransport(bus, &uartTransport, uart);
+
+    return true;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Select UART frames of speed mode (baud rate set on next access)
+ */
+static void UartConfigSpeed(void *context, OwSpeedMode_t speedMode)
+{
+    OwUart_t *uart = context;
+
+    uart->speedMode = (speedMode <= OW_OVERLOAD_SPEED) ? speedMode : OW_STANDARD_SPEED;
+}
+
+
+/*
+ *  Generate a reset sequence and return presence detected
+ */
+static bool UartReset(void *context)
+{
+    OwUart_t *uart = context;
+    const UartTiming_t *timing = &uartTiming[uart->speedMode];
+    uint8_t rxData;
+
+    SetBaud(uart, timing->resetBaud);
+    uart->port.exchange(&timing->resetByte, &rxData, 1);
+    SetBaud(uart, timing->slotBaud);
+
+    return (rxData != timing->resetByte);
+}
+
+
+/*
+ *  Transfer bits (LSB first) as one UART byte per slot, in chunks of
+ *  OW_UART_CHUNK_SIZE slots per exchange
+ */
+static void UartTransfer(void *context, uint8_t *dataBuff, uint16_t bitCount, bool isRead)
+{
+    OwUart_t *uart = context;
+    uint8_t txData[OW_UART_CHUNK_SIZE], rxData[OW_UART_CHUNK_SIZE];
+    uint16_t chunkSize, bitIdx;
+
+    SetBaud(uart, uartTiming[uart->speedMode].slotBaud);
+
+    for (uint16_t chunkIdx = 0; chunkIdx < bitCount; chunkIdx += chunkSize)
+    {
+        chunkSize = ((bitCount - chunkIdx) < OW_UART_CHUNK_SIZE) ? (bitCount - chunkIdx) : OW_UART_CHUNK_SIZE;
+
+        for (uint16_t slotIdx = 0; slotIdx < chunkSize; slotIdx++)
+        {
+            bitIdx = chunkIdx + slotIdx;
+            txData[slotIdx] = (isRead || ((dataBuff[bitIdx / 8] >> (bitIdx % 8)) & 0x01)) ? 0xFF : 0x00;
+        }
+
+        uart->port.exchange(txData, rxData, chunkSize);
+
+        if (isRead)
+        {
+            for (uint16_t slotIdx = 0; slotIdx < chunkSize; slotIdx++)
+            {
+                bitIdx = chunkIdx + slotIdx;
+                dataBuff[bitIdx / 8] = ((bitIdx % 8) == 0) ? 0x00 : dataBuff[bitIdx / 8];
+                dataBuff[bitIdx / 8] |= ((rxData[slotIdx] == 0xFF) ? 1 : 0) << (bitIdx % 8);
+            }
+        }
+    }
+}
+
+
+/*
+ *  Change baud rate if it differs from the current one
+ */
+static INLINE void SetBaud(OwUart_t *uart, uint32_t baudRate)
+{
+    if (uart->baudRate != baudRate)
+    {
+        uart->port.setBaud(baudRate);
+        uart->baudRate = baudRate;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef ONEWIREUART_H
+#define	ONEWIREUART_H
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "OneWire.h"
+
+/******************************************************************************/
+/*---------------------------------Macros-------------------------------------*/
+/******************************************************************************/
+
+/** Max. slots (UART bytes) handed to the exchange hook at once **/
+#define OW_UART_CHUNK_SIZE      64
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* UART baud rate hook (called only between exchanges, TX is idle) */
+typedef void (*OwUartSetBaud_t)(uint32_t baudRate);
+
+/* UART exchange hook: send bytes (8N1) and return bytes received meanwhile */
+/* Blocks until done - CPU is free if it waits for DMA/FIFO (e.g. yields) */
+typedef void (*OwUartExchange_t)(const uint8_t *txData, uint8_t *rxData, uint16_t dataLen);
+
+/* UART with open-drain TX and RX both tied to the OW bus line */
+typedef struct {
+    OwUartSetBaud_t     setBaud;
+    OwUartExchange_t    exchange;
+} OwUartPort_t;
+
+/* UART transport context (one per UART bus, owned by caller) */
+typedef struct {
+    OwUartPort_t    port;
+    OwSpeedMode_t   speedMode;
+    uint32_t        baudRate;       // Currently set (0 - unknown)
+} OwUart_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool OW_UartConfig(OwBus_t *bus, OwUart_t *uart, OwUartPort_t port);
+
+#endif	/* ONEWIREUART_H */
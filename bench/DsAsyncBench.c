@@ -0,0 +1,293 @@
+/*
+ *  Superloop responsiveness, blocking calls vs. queued DS18B20_Async* requests
+ *
+ *  Simulated DS18B20 share one bus (externally or parasite powered). The
+ *  same sequence - search, configuration saved to EEPROM, conversion, read,
+ *  save and recall - is run once as blocking calls and once queued at once
+ *  and executed by DS18B20_AsyncTick from a superloop that then spends
+ *  100 us (one run 250 ms) on other work. One CSV row per run, mode and
+ *  operation reports its status and result (devices found or read), the
+ *  time until it completed and the longest time the superloop was blocked by
+ *  it (one blocking call or the longest tick).
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20Async.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_PULLUP_PIN_CODE   GPIO_RPB6
+#define BENCH_MAX_DEVICE_COUNT  32
+#define BENCH_OP_COUNT          6
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+typedef struct {
+    uint8_t     deviceCount;
+    bool        isParasite;
+    uint32_t    loopUs;         // Other superloop work per tick
+} BenchRun_t;
+
+/* Outcome of one operation */
+typedef struct {
+    DsAsyncStatus_t status;
+    uint32_t        result;
+    uint64_t        doneNs;     // Completion time since sequence start
+    uint64_t        maxBlockNs;
+    uint32_t        tickCount;
+} BenchOp_t;
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const BenchRun_t benchRun[] = {
+    {8, false, 100},
+    {32, false, 100},
+    {8, true, 100},
+    {16, false, 250000}
+};
+
+static const DsAsyncOp_t opSequence[BENCH_OP_COUNT] = {
+    DS_ASYNC_SEARCH, DS_ASYNC_CONFIG, DS_ASYNC_CONVERT, DS_ASYNC_READ, DS_ASYNC_SAVE, DS_ASYNC_RECALL
+};
+
+static const char *opName[] = {"search", "search_alarm", "convert", "read", "config_saved", "save", "recall"};
+static const char *modeName[] = {"blocking", "async"};
+
+static DsBus_t dsBus;
+static DsAsync_t dsAsync;
+static DsDevice_t device[BENCH_MAX_DEVICE_COUNT];
+static float tempData[BENCH_MAX_DEVICE_COUNT];
+static BenchOp_t benchOp[BENCH_OP_COUNT];
+static uint8_t doneCount;
+static uint64_t startNs;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static bool SetupBus(const BenchRun_t *run);
+static void RunBlocking(const BenchRun_t *run);
+static void RunAsync(const BenchRun_t *run);
+static void OpDone(void *context, DsAsyncOp_t op, DsAsyncStatus_t status, uint32_t result);
+static DsConfig_t GetConfig(const BenchRun_t *run);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("devices,parasite,loop_us,mode,op,ok,result,done_ms,max_block_ms,ticks\n");
+
+    for (uint8_t runIdx = 0; runIdx < sizeof(benchRun) / sizeof(benchRun[0]); runIdx++)
+    {
+        const BenchRun_t *run = &benchRun[runIdx];
+
+        for (uint8_t modeIdx = 0; modeIdx < 2; modeIdx++)
+        {
+            bool isOk = SetupBus(run);
+
+            for (uint8_t opIdx = 0; opIdx < BENCH_OP_COUNT; opIdx++)
+            {
+                benchOp[opIdx] = (BenchOp_t){.status = DS_ASYNC_ERROR};
+            }
+            doneCount = 0;
+
+            if (isOk && (modeIdx == 0))
+            {
+                RunBlocking(run);
+            }
+            else if (isOk)
+            {
+                RunAsync(run);
+            }
+
+            for (uint8_t opIdx = 0; opIdx < BENCH_OP_COUNT; opIdx++)
+            {
+                BenchOp_t *op = &benchOp[opIdx];
+
+                printf("%u,%d,%u,%s,%s,%d,%u,%.2f,%.2f,%u\n",
+                       run->deviceCount, dsBus.isParasite, run->loopUs, modeName[modeIdx], opName[opSequence[opIdx]],
+                       (op->status == DS_ASYNC_OK), op->result, op->doneNs / 1e6, op->maxBlockNs / 1e6,
+                       op->tickCount);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Attach devices to fresh simulated bus and detect its power mode
+ */
+static bool SetupBus(const BenchRun_t *run)
+{
+    OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+    OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+    OWSIM_SetPullupPin(BENCH_PIN_CODE, BENCH_PULLUP_PIN_CODE, true);
+    for (uint8_t devIdx = 0; devIdx < run->deviceCount; devIdx++)
+    {
+        int32_t simIdx = OWSIM_AddDevice(BENCH_PIN_CODE, 0x0000A5C00000 + devIdx);
+
+        OWSIM_SetTemp(simIdx, 20.0 + devIdx * 0.25);
+        OWSIM_SetParasite(simIdx, run->isParasite);
+    }
+
+    DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+    OW_ConfigPullup(&dsBus.owBus, BENCH_PULLUP_PIN_CODE, true);
+
+    return DS18B20_DetectPowerMode(&dsBus, NULL) && DS18B20_AsyncInit(&dsAsync, &dsBus);
+}
+
+
+/*
+ *  Run sequence as blocking calls (each call blocks the superloop)
+ */
+static void RunBlocking(const BenchRun_t *run)
+{
+    startNs = OWSIM_GetTimeNs();
+
+    for (uint8_t opIdx = 0; opIdx < BENCH_OP_COUNT; opIdx++)
+    {
+        uint64_t callNs = OWSIM_GetTimeNs();
+        uint32_t result = 0;
+        bool isOk;
+
+        switch (opSequence[opIdx])
+        {
+            case DS_ASYNC_SEARCH:
+                result = DS18B20_SearchDeviceId(&dsBus, device);
+                isOk = (result > 0);
+                break;
+
+            case DS_ASYNC_CONFIG:
+                isOk = DS18B20_ConfigDevice(&dsBus, GetConfig(run), true);
+                break;
+
+            case DS_ASYNC_CONVERT:
+                isOk = DS18B20_ConvertReadTemp(&dsBus, device, tempData, run->deviceCount);
+                result = isOk ? run->deviceCount : 0;
+                break;
+
+            case DS_ASYNC_READ:
+                isOk = DS18B20_ReadTemp(&dsBus, device, tempData, run->deviceCount);
+                result = isOk ? run->deviceCount : 0;
+                break;
+
+            case DS_ASYNC_SAVE:
+                isOk = DS18B20_SaveToRom(&dsBus, NULL, true);
+                break;
+
+            default:
+                isOk = DS18B20_CopyFromRom(&dsBus, NULL, true);
+                break;
+        }
+
+        BenchOp_t *op = &benchOp[opIdx];
+        op->status = isOk ? DS_ASYNC_OK : DS_ASYNC_ERROR;
+        op->result = result;
+        op->doneNs = OWSIM_GetTimeNs() - startNs;
+        op->maxBlockNs = OWSIM_GetTimeNs() - callNs;
+        op->tickCount = 1;
+
+        OWSIM_AdvanceUs(run->loopUs);
+    }
+}
+
+
+/*
+ *  Queue whole sequence at once and run it from superloop ticks
+ */
+static void RunAsync(const BenchRun_t *run)
+{
+    bool isOk = true;
+
+    startNs = OWSIM_GetTimeNs();
+
+    for (uint8_t opIdx = 0; opIdx < BENCH_OP_COUNT; opIdx++)
+    {
+        switch (opSequence[opIdx])
+        {
+            case DS_ASYNC_SEARCH:
+                isOk = DS18B20_AsyncSearch(&dsAsync, device, OpDone, NULL) && isOk;
+                break;
+
+            case DS_ASYNC_CONFIG:
+                isOk = DS18B20_AsyncConfig(&dsAsync, GetConfig(run), true, OpDone, NULL) && isOk;
+                break;
+
+            case DS_ASYNC_CONVERT:
+                isOk = DS18B20_AsyncConvert(&dsAsync, device, tempData, run->deviceCount, OpDone, NULL) && isOk;
+                break;
+
+            case DS_ASYNC_READ:
+                isOk = DS18B20_AsyncRead(&dsAsync, device, tempData, run->deviceCount, OpDone, NULL) && isOk;
+                break;
+
+            case DS_ASYNC_SAVE:
+                isOk = DS18B20_AsyncSave(&dsAsync, NULL, true, OpDone, NULL) && isOk;
+                break;
+
+            default:
+                isOk = DS18B20_AsyncRecall(&dsAsync, NULL, true, OpDone, NULL) && isOk;
+                break;
+        }
+    }
+
+    /* Superloop */
+    while (isOk && DS18B20_AsyncIsBusy(&dsAsync))
+    {
+        BenchOp_t *op = &benchOp[doneCount];
+        uint64_t tickNs = OWSIM_GetTimeNs();
+
+        DS18B20_AsyncTick(&dsAsync);
+        tickNs = OWSIM_GetTimeNs() - tickNs;
+        op->maxBlockNs = (tickNs > op->maxBlockNs) ? tickNs : op->maxBlockNs;
+        op->tickCount++;
+
+        OWSIM_AdvanceUs(run->loopUs);
+    }
+}
+
+
+/*
+ *  Record completion of queued operation (completed in queue order)
+ */
+static void OpDone(void *context, DsAsyncOp_t op, DsAsyncStatus_t status, uint32_t result)
+{
+    (void)context;
+    (void)op;
+
+    benchOp[doneCount].status = status;
+    benchOp[doneCount].result = result;
+    benchOp[doneCount].doneNs = OWSIM_GetTimeNs() - startNs;
+    doneCount++;
+}
+
+
+/*
+ *  Alarm and 10-bit resolution settings of all devices, saved to EEPROM
+ */
+static DsConfig_t GetConfig(const BenchRun_t *run)
+{
+    return (DsConfig_t){
+        .measRes = DS_MEAS_RES_10BIT,
+        .device = device,
+        .deviceCount = run->deviceCount,
+        .highAlarm = 50,
+        .lowAlarm = -10,
+        .isSaved = true
+    };
+}
@@ -0,0 +1,211 @@
+/*
+ *  Bus-time benchmark of public DS18B20_* operations on the simulated bus
+ *
+ *  Every operation is run once per device count and speed mode. One CSV row
+ *  is printed per call with simulated bus-occupied time, elapsed time,
+ *  interrupt-masked time, reset count and bytes transferred.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_MAX_DEVICE_COUNT  128
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const uint32_t benchDeviceCount[] = {1, 8, 32, 128};
+
+static const OwSpeedMode_t benchSpeedMode[] = {
+    OW_STANDARD_SPEED,
+    OW_HIGH_SPEED,
+    OW_OVERLOAD_SPEED
+};
+
+static const char *speedName[] = {
+    [OW_STANDARD_SPEED] = "standard",
+    [OW_HIGH_SPEED] = "high",
+    [OW_OVERLOAD_SPEED] = "overdrive"
+};
+
+static DsBus_t dsBus;
+static DsDevice_t device[BENCH_MAX_DEVICE_COUNT];
+static float tempData[BENCH_MAX_DEVICE_COUNT];
+static int ramData[BENCH_MAX_DEVICE_COUNT * 3];
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void SetUpBus(uint32_t deviceCount, OwSpeedMode_t speedMode);
+static void Report(const char *opName, OwSpeedMode_t speedMode, uint32_t deviceCount, bool isOk);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("op,speed,devices,ok,bus_us,elapsed_us,masked_us,max_masked_us,resets,slots,bytes\n");
+
+    for (uint8_t cntIdx = 0; cntIdx < sizeof(benchDeviceCount) / sizeof(benchDeviceCount[0]); cntIdx++)
+    {
+        uint32_t deviceCount = benchDeviceCount[cntIdx];
+
+        for (uint8_t modeIdx = 0; modeIdx < sizeof(benchSpeedMode) / sizeof(benchSpeedMode[0]); modeIdx++)
+        {
+            OwSpeedMode_t speedMode = benchSpeedMode[modeIdx];
+            bool isMultiMode = (deviceCount > 1);
+            bool isOk;
+
+            SetUpBus(deviceCount, speedMode);
+
+            /* Search always runs at standard speed */
+            if (speedMode == OW_STANDARD_SPEED)
+            {
+                OWSIM_ResetStats();
+                isOk = (DS18B20_SearchDeviceId(&dsBus, device) == deviceCount);
+                Report("SearchDeviceId", speedMode, deviceCount, isOk);
+            }
+
+            /* Known ROMs are used so that a failed search doesn't skew the rest */
+            for (uint32_t idx = 0; idx < deviceCount; idx++)
+            {
+                DS18B20_InitDevice(&device[idx], OWSIM_GetRomId(idx));
+            }
+
+            DsConfig_t dsConfig = {
+                .measRes = DS_MEAS_RES_12BIT,
+                .device = &device[0],
+                .deviceCount = deviceCount,
+                .highAlarm = 40,
+                .lowAlarm = 10
+            };
+            DS18B20_ConfigDevice(&dsBus, dsConfig, isMultiMode);
+
+            OWSIM_ResetStats();
+            isOk = DS18B20_ConvertReadTemp(&dsBus, device, tempData, deviceCount);
+            Report("ConvertReadTemp", speedMode, deviceCount, isOk);
+
+            /* Tracked 9-bit resolution shortens the conversion deadline */
+            dsConfig.measRes = DS_MEAS_RES_9BIT;
+            DS18B20_ConfigDevice(&dsBus, dsConfig, isMultiMode);
+            OWSIM_ResetStats();
+            isOk = DS18B20_ConvertReadTemp(&dsBus, device, tempData, deviceCount);
+            Report("ConvertReadTemp9Bit", speedMode, deviceCount, isOk);
+
+            /* Recall of 12-bit EEPROM setting lengthens it again */
+            DS18B20_CopyFromRom(&dsBus, &device[0], isMultiMode);
+            OWSIM_ResetStats();
+            isOk = DS18B20_ConvertReadTemp(&dsBus, device, tempData, deviceCount);
+            Report("ConvertReadTempRecall", speedMode, deviceCount, isOk);
+            dsConfig.measRes = DS_MEAS_RES_12BIT;
+            DS18B20_ConfigDevice(&dsBus, dsConfig, isMultiMode);
+
+            /* Non-blocking conversion (CPU free while sensors convert) */
+            DsConvJob_t convJob;
+            OWSIM_ResetStats();
+            isOk = DS18B20_StartConv(&dsBus, &convJob, device, tempData, deviceCount);
+            Report("StartConv", speedMode, deviceCount, isOk);
+
+            OWSIM_ResetStats();
+            isOk = (DS18B20_PollConv(&convJob) == DS_CONV_BUSY);
+            Report("PollConv", speedMode, deviceCount, isOk);
+
+            OWSIM_AdvanceUs(800000);
+            OWSIM_ResetStats();
+            isOk = (DS18B20_CompleteConv(&convJob) == DS_CONV_DONE);
+            Report("CompleteConv", speedMode, deviceCount, isOk);
+
+            OWSIM_ResetStats();
+            isOk = DS18B20_ReadTemp(&dsBus, device, tempData, deviceCount);
+            Report("ReadTemp", speedMode, deviceCount, isOk);
+
+            /* Temperature bytes only with plausibility check */
+            DS18B20_SetFastRead(&dsBus, true);
+            OWSIM_ResetStats();
+            isOk = DS18B20_ReadTemp(&dsBus, device, tempData, deviceCount);
+            Report("ReadTempFast", speedMode, deviceCount, isOk);
+
+            /* Genuine 85 degC reading confirmed by a full scratch-pad read */
+            OWSIM_SetTemp(0, 85.0);
+            DS18B20_ConvertReadTemp(&dsBus, device, tempData, deviceCount);
+            OWSIM_ResetStats();
+            isOk = DS18B20_ReadTemp(&dsBus, device, tempData, deviceCount) && (tempData[0] == 85.0);
+            Report("ReadTempFast85C", speedMode, deviceCount, isOk);
+
+            /* Silent device (reads all ones) must not be reported as -0.0625 degC */
+            OWSIM_SetDetached(0, true);
+            OWSIM_ResetStats();
+            isOk = !DS18B20_ReadTemp(&dsBus, device, tempData, deviceCount) && !device[0].isDataValid;
+            Report("ReadTempFastDetached", speedMode, deviceCount, isOk);
+            OWSIM_SetDetached(0, false);
+            DS18B20_SetFastRead(&dsBus, false);
+
+            OWSIM_ResetStats();
+            isOk = DS18B20_ReadRam(&dsBus, device, ramData, deviceCount);
+            Report("ReadRam", speedMode, deviceCount, isOk);
+
+            OWSIM_ResetStats();
+            isOk = DS18B20_SaveToRom(&dsBus, device, isMultiMode);
+            Report("SaveToRom", speedMode, deviceCount, isOk);
+
+            /* Runs last as it re-configures the device to 9-bit resolution */
+            OWSIM_ResetStats();
+            isOk = !DS18B20_IsDeviceFake(&dsBus, &device[0]);
+            Report("IsDeviceFake", speedMode, deviceCount, isOk);
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Create a fresh bus with given amount of devices
+ */
+static void SetUpBus(uint32_t deviceCount, OwSpeedMode_t speedMode)
+{
+    OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+    OWSIM_AddBus(BENCH_PIN_CODE, speedMode);
+    DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = speedMode});
+
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
+    {
+        /* Spread serials so that search hits discrepancies at many bits */
+        uint64_t serial = (0x9E3779B97F4A7C15ULL * (idx + 1)) >> 16;
+        int32_t devIdx = OWSIM_AddDevice(BENCH_PIN_CODE, serial);
+        OWSIM_SetTemp(devIdx, 20.0 + (float)idx / 16);
+    }
+
+    memset(device, 0, sizeof(device));
+}
+
+
+/*
+ *  Print one CSV row with counters accumulated since last reset
+ */
+static void Report(const char *opName, OwSpeedMode_t speedMode, uint32_t deviceCount, bool isOk)
+{
+    OwSimStats_t stats;
+    OWSIM_GetStats(&stats);
+
+    printf("%s,%s,%u,%d,%llu,%llu,%llu,%llu,%u,%u,%u\n",
+           opName, speedName[speedMode], deviceCount, isOk,
+           (unsigned long long)(stats.busyNs / 1000),
+           (unsigned long long)(stats.timeNs / 1000),
+           (unsigned long long)(stats.maskedNs / 1000),
+           (unsigned long long)(stats.maxMaskedNs / 1000),
+           stats.resetCount, stats.slotCount, stats.slotCount / 8);
+}
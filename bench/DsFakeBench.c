@@ -0,0 +1,139 @@
+/*
+ *  Fake device detection, one device per call vs. whole bus in one window
+ *
+ *  For 1, 8, 32 and 64 simulated DS18B20 (every 4th one a fake with fixed
+ *  12-bit conversion time) all devices are checked once with a loop over
+ *  DS18B20_IsDeviceFake() and once with DS18B20_FindFakeDevices(), first
+ *  with power-on temperature registers and then after a conversion at the
+ *  configured resolution (genuine devices whose 9-bit result equals it keep
+ *  an unchanged register), each with settings in RAM only and with settings
+ *  saved to EEPROM (FindFakeDevices then restores them by one recall). One
+ *  CSV row per run reports elapsed time, the
+ *  number of devices reported fake, whether every device was classified
+ *  correctly and whether alarm values and resolution of all devices were
+ *  left unchanged. On a parasite powered bus both checks must be refused
+ *  without bus access, "ok" then reports the refusal and no device may be
+ *  reported fake.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_MAX_DEVICE_COUNT  64
+#define BENCH_FAKE_INTERVAL     4       // Every n-th serial number is fake
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const uint32_t benchDeviceCount[] = {1, 8, 32, 64};
+
+static DsDevice_t device[BENCH_MAX_DEVICE_COUNT];
+static bool isFake[BENCH_MAX_DEVICE_COUNT];
+static int ramData[2][BENCH_MAX_DEVICE_COUNT * 3];
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("devices,parasite,saved,prev_conv,method,ok,elapsed_ms,fakes,correct,config_kept\n");
+
+    for (uint8_t countIdx = 0; countIdx < sizeof(benchDeviceCount) / sizeof(benchDeviceCount[0]); countIdx++)
+    {
+        uint32_t deviceCount = benchDeviceCount[countIdx];
+
+        for (uint8_t runIdx = 0; runIdx < 10; runIdx++)
+        {
+            bool isBatch = runIdx & 0x01;
+            bool isPrevConv = (runIdx & 0x02) && (runIdx < 8);
+            bool isSaved = (runIdx & 0x04) && (runIdx < 8);
+            bool isParasite = (runIdx >= 8);
+            OwSimStats_t stats;
+            DsBus_t dsBus;
+            uint32_t fakeCount = 0;
+            bool isOk = true, isCorrect = true;
+
+            OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+            OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+            for (uint32_t idx = 0; idx < deviceCount; idx++)
+            {
+                int32_t simIdx = OWSIM_AddDevice(BENCH_PIN_CODE, 0x0000FA4E0000 + idx);
+                OWSIM_SetTemp(simIdx, 20.0 + (float)idx / 16);
+                OWSIM_SetFake(simIdx, (idx % BENCH_FAKE_INTERVAL) == (BENCH_FAKE_INTERVAL - 1));
+                OWSIM_SetParasite(simIdx, isParasite);
+            }
+
+            DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+            if ((DS18B20_SearchDeviceId(&dsBus, device) != deviceCount) || !DS18B20_DetectPowerMode(&dsBus, NULL))
+            {
+                return 1;
+            }
+
+            /* 11-bit resolution and distinct alarm values to be restored */
+            DsConfig_t dsConfig = {.measRes = DS_MEAS_RES_11BIT, .highAlarm = 45, .lowAlarm = -5};
+            for (uint32_t idx = 0; idx < deviceCount; idx++)
+            {
+                dsConfig.device = &device[idx];
+                dsConfig.highAlarm = 45 + (device[idx].romId & 0x0F);
+                isOk = isOk && DS18B20_ConfigDevice(&dsBus, dsConfig, false);
+                isOk = isOk && (!isSaved || DS18B20_SaveToRom(&dsBus, &device[idx], false));
+            }
+            isOk = isOk && DS18B20_ReadRam(&dsBus, device, ramData[0], deviceCount);
+
+            /* Temperature registers hold result of configured resolution */
+            if (isPrevConv)
+            {
+                isOk = isOk && DS18B20_ConvertTemp(&dsBus, device, deviceCount);
+                OWSIM_AdvanceUs(800000);
+            }
+
+            /* Parasite bus: FindFakeDevices must fail */
+            memset(isFake, 0, sizeof(isFake));
+            OWSIM_ResetStats();
+            if (isBatch)
+            {
+                isOk = isOk && (DS18B20_FindFakeDevices(&dsBus, device, isFake, deviceCount) != isParasite);
+            }
+            else
+            {
+                for (uint32_t idx = 0; idx < deviceCount; idx++)
+                {
+                    isFake[idx] = DS18B20_IsDeviceFake(&dsBus, &device[idx]);
+                }
+            }
+            OWSIM_GetStats(&stats);
+
+            /* Fakes set from serial number (parasite bus: none reported) */
+            for (uint32_t idx = 0; idx < deviceCount; idx++)
+            {
+                bool isFakeSet = (((device[idx].romId & 0xFF) % BENCH_FAKE_INTERVAL) == (BENCH_FAKE_INTERVAL - 1));
+
+                fakeCount += isFake[idx] ? 1 : 0;
+                isCorrect = isCorrect && (isFake[idx] == (isFakeSet && !isParasite));
+            }
+
+            /* Parasite bus: check refused without bus access */
+            isOk = isOk && (!isParasite || (stats.resetCount == 0));
+
+            /* Wait for any running conversion before reading settings back */
+            OWSIM_AdvanceUs(800000);
+            isOk = isOk && DS18B20_ReadRam(&dsBus, device, ramData[1], deviceCount);
+
+            printf("%u,%d,%d,%d,%s,%d,%.1f,%u,%d,%d\n",
+                   deviceCount, dsBus.isParasite, isSaved, isPrevConv, isBatch ? "FindFakeDevices" : "IsDeviceFake", isOk,
+                   stats.timeNs / 1e6, fakeCount, isCorrect,
+                   memcmp(ramData[0], ramData[1], deviceCount * 3 * sizeof(int)) == 0);
+        }
+    }
+
+    return 0;
+}
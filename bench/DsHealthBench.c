@@ -0,0 +1,103 @@
+/*
+ *  Bus time per conversion cycle with a dead sensor, with and without
+ *  quarantine (DS18B20_SetQuarantine)
+ *
+ *  Sixteen simulated DS18B20 share one bus and one of them returns corrupted
+ *  scratch-pads until it is repaired at cycle 20. Each conversion cycle is
+ *  run once without quarantine and once with quarantine after 3 failed reads
+ *  and a probe every 8th cycle. One CSV row per cycle reports the bus-busy
+ *  time and re-reads of the scratch-pad reads of that cycle, the number of valid devices and the
+ *  health record of the failing device.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_DEVICE_COUNT      16
+#define BENCH_CYCLE_COUNT       32
+#define BENCH_DEAD_DEVICE       5       // Serial number digit of failing device
+#define BENCH_REPAIR_CYCLE      20
+#define BENCH_FAIL_COUNT        3
+#define BENCH_PROBE_CYCLE_COUNT 7
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("quarantine,cycle,ok,valid_devices,busy_us,retries,skips,dead_fail_streak,dead_quarantined,dead_error_pct\n");
+
+    for (uint8_t isQuarantine = 0; isQuarantine <= 1; isQuarantine++)
+    {
+        DsDevice_t device[BENCH_DEVICE_COUNT];
+        float tempData[BENCH_DEVICE_COUNT];
+        DsBus_t dsBus;
+        uint8_t deadIdx = 0;
+
+        OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+        OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+        for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+        {
+            OWSIM_SetTemp(OWSIM_AddDevice(BENCH_PIN_CODE, 0x0000EA170000 + devIdx), 20.0 + devIdx);
+        }
+
+        DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+        if (isQuarantine)
+        {
+            DS18B20_SetQuarantine(&dsBus, BENCH_FAIL_COUNT, BENCH_PROBE_CYCLE_COUNT);
+        }
+
+        if (DS18B20_SearchDeviceId(&dsBus, device) != BENCH_DEVICE_COUNT)
+        {
+            return 1;
+        }
+
+        /* Found in ROM order, simulator index by serial */
+        for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+        {
+            deadIdx = ((device[devIdx].romId & 0x0F) == BENCH_DEAD_DEVICE) ? devIdx : deadIdx;
+        }
+        OWSIM_SetReadErrors(BENCH_DEAD_DEVICE, UINT32_MAX);
+
+        for (uint8_t cycleIdx = 0; cycleIdx < BENCH_CYCLE_COUNT; cycleIdx++)
+        {
+            const DsHealth_t *health = &device[deadIdx].health;
+            uint8_t validCount = 0;
+            DsStats_t stats;
+            bool isOk;
+
+            if (cycleIdx == BENCH_REPAIR_CYCLE)
+            {
+                OWSIM_SetReadErrors(BENCH_DEAD_DEVICE, 0);
+            }
+
+            /* Counters of scratch-pad reads only */
+            DsConvJob_t convJob;
+            DS18B20_StartConv(&dsBus, &convJob, device, tempData, BENCH_DEVICE_COUNT);
+            while (DS18B20_PollConv(&convJob) == DS_CONV_BUSY);
+            DS18B20_ResetStats(&dsBus, NULL, 0);
+            isOk = (DS18B20_CompleteConv(&convJob) == DS_CONV_DONE);
+            DS18B20_GetStats(&dsBus, &stats);
+
+            for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+            {
+                validCount += device[devIdx].isDataValid ? 1 : 0;
+            }
+
+            printf("%s,%u,%d,%u,%llu,%u,%u,%u,%d,%.1f\n",
+                   isQuarantine ? "on" : "off", cycleIdx, isOk, validCount,
+                   (unsigned long long)stats.busyUs, stats.retryCount, stats.quarantineSkipCount,
+                   health->failStreak, health->isQuarantined,
+                   (health->readCount > 0) ? (100.0 * health->failCount / health->readCount) : 0.0);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ *  Parasite power detection and strong pull-up timing
+ *
+ *  Four simulated DS18B20 share one bus. Each run powers all, one or none of
+ *  them from the data line and lets the driver either assume external power
+ *  or detect the power mode (DS18B20_DetectPowerMode). The strong pull-up is
+ *  a separate switch pin (P-MOSFET, active LOW) or the bus pin driven HIGH.
+ *  One CSV row per run and resolution reports the detected mode, whether all
+ *  temperatures were read correctly, the conversion time, whether the alarm
+ *  settings were copied to EEPROM and whether a DS18B20_ConvertTemp call
+ *  followed by a DS18B20_IsConvDone loop (early DS18B20_ReadTemp refused)
+ *  read all temperatures. On a parasite bus DS18B20_ReadRam and a search
+ *  started during that conversion must also be refused without a reset.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_PULLUP_PIN_CODE   GPIO_RPB6
+#define BENCH_DEVICE_COUNT      4
+#define BENCH_LOOP_US           100     // Other superloop work per done check
+#define BENCH_CONV_MAX_US       1000000 // Done check loop given up after
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+typedef struct {
+    const char  *name;
+    uint8_t     parasiteCount;      // First devices powered from data line
+    bool        isDetected;         // DS18B20_DetectPowerMode called
+    uint32_t    pullupPinCode;      // 0 - bus pin driven HIGH
+} BenchRun_t;
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const BenchRun_t benchRun[] = {
+    {"external", 0, true, BENCH_PULLUP_PIN_CODE},
+    {"parasite_assumed_external", BENCH_DEVICE_COUNT, false, BENCH_PULLUP_PIN_CODE},
+    {"parasite_switch_pin", BENCH_DEVICE_COUNT, true, BENCH_PULLUP_PIN_CODE},
+    {"parasite_bus_pin", BENCH_DEVICE_COUNT, true, 0},
+    {"mixed_switch_pin", 1, true, BENCH_PULLUP_PIN_CODE}
+};
+
+static const char *resName[] = {"9bit", "10bit", "11bit", "12bit"};
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("run,res,parasite,ok,temp_ok,conv_ms,eeprom_ok,direct_ok,busy_ok\n");
+
+    for (uint8_t runIdx = 0; runIdx < sizeof(benchRun) / sizeof(benchRun[0]); runIdx++)
+    {
+        const BenchRun_t *run = &benchRun[runIdx];
+
+        for (DsMeasRes_t measRes = DS_MEAS_RES_9BIT; measRes <= DS_MEAS_RES_12BIT; measRes++)
+        {
+            DsDevice_t device[BENCH_DEVICE_COUNT], searchBuff[BENCH_DEVICE_COUNT];
+            float tempData[BENCH_DEVICE_COUNT];
+            int ramData[BENCH_DEVICE_COUNT * 3];
+            uint8_t eepromData[3];
+            OwSimStats_t stats;
+            DsBus_t dsBus;
+            bool isOk, isTempOk = true, isEepromOk = true, isDirectOk, isBusyOk;
+
+            OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+            OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+            OWSIM_SetPullupPin(BENCH_PIN_CODE, run->pullupPinCode, true);
+            for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+            {
+                int32_t simIdx = OWSIM_AddDevice(BENCH_PIN_CODE, 0x00000FA5E000 + devIdx);
+                OWSIM_SetTemp(simIdx, 20.0 + devIdx);
+                OWSIM_SetParasite(simIdx, devIdx < run->parasiteCount);
+            }
+
+            DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+            OW_ConfigPullup(&dsBus.owBus, run->pullupPinCode, true);
+            isOk = (DS18B20_SearchDeviceId(&dsBus, device) == BENCH_DEVICE_COUNT);
+            if (run->isDetected)
+            {
+                isOk = isOk && DS18B20_DetectPowerMode(&dsBus, NULL);
+            }
+
+            /* Alarm settings copied to EEPROM of all devices */
+            DsConfig_t dsConfig = {.measRes = measRes, .device = device, .deviceCount = BENCH_DEVICE_COUNT,
+                                   .highAlarm = 50, .lowAlarm = -10};
+            isOk = isOk && DS18B20_ConfigDevice(&dsBus, dsConfig, true) && DS18B20_SaveToRom(&dsBus, NULL, true);
+
+            uint64_t startNs = OWSIM_GetTimeNs();
+            isOk = DS18B20_ConvertReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT) && isOk;
+            uint64_t convNs = OWSIM_GetTimeNs() - startNs;
+
+            /* Temperature was set from lowest serial number digit */
+            for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+            {
+                uint8_t simIdx = device[devIdx].romId & 0x0F;
+
+                isTempOk = isTempOk && (tempData[devIdx] == (float)(20.0 + simIdx));
+                OWSIM_GetEeprom(simIdx, eepromData);
+                isEepromOk = isEepromOk && (eepromData[0] == 50) && (eepromData[1] == (0x80 | 10));
+            }
+
+            /* Conversion started directly and polled as in the example */
+            isDirectOk = DS18B20_ConvertTemp(&dsBus, NULL, BENCH_DEVICE_COUNT);
+            isDirectOk = !DS18B20_ReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT) && isDirectOk;
+
+            /* Bus not touched while strong pull-up powers the conversion */
+            OWSIM_ResetStats();
+            isBusyOk = !DS18B20_ReadRam(&dsBus, device, ramData, BENCH_DEVICE_COUNT);
+            isBusyOk = (DS18B20_SearchDeviceId(&dsBus, searchBuff) == 0) && isBusyOk;
+            OWSIM_GetStats(&stats);
+            isBusyOk = !dsBus.isParasite || (isBusyOk && (stats.resetCount == 0));
+            startNs = OWSIM_GetTimeNs();
+            while (!DS18B20_IsConvDone(&dsBus) && ((OWSIM_GetTimeNs() - startNs) < BENCH_CONV_MAX_US * 1000ULL))
+            {
+                OWSIM_AdvanceUs(BENCH_LOOP_US);
+            }
+            isDirectOk = DS18B20_ReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT) && isDirectOk;
+            for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+            {
+                isDirectOk = isDirectOk && (tempData[devIdx] == (float)(20.0 + (device[devIdx].romId & 0x0F)));
+            }
+
+            printf("%s,%s,%d,%d,%d,%.1f,%d,%d,%d\n",
+                   run->name, resName[measRes], dsBus.isParasite, isOk, isTempOk, convNs / 1e6, isEepromOk,
+                   isDirectOk, isBusyOk);
+        }
+    }
+
+    return 0;
+}
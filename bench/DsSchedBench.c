@@ -0,0 +1,198 @@
+/*
+ *  Fixed-rate acquisition of many sensors with DS18B20_SchedTick
+ *
+ *  Buses of simulated DS18B20 are registered with the scheduler as one
+ *  group each (first samples spread by DS18B20_SchedStart) and sampled for
+ *  twenty periods from a superloop that calls DS18B20_SchedTick and then
+ *  spends 100 us on other work. Bit-banged reads of all buses share the CPU,
+ *  so runs whose reads don't fit into the period miss deadlines. One CSV row
+ *  per run reports sample and miss counts, the actual period and start jitter
+ *  over all groups, the longest planned start to sample done latency, the
+ *  bus occupancy and the longest tick call (superloop responsiveness).
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20Sched.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_MAX_BUS_COUNT     8
+#define BENCH_MAX_DEVICE_COUNT  64      // Per bus
+#define BENCH_FIRST_PIN         5       // Buses on RB5 and up
+#define BENCH_PERIOD_COUNT      20
+#define BENCH_LOOP_US           100     // Other superloop work per tick
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+typedef struct {
+    uint8_t     busCount;
+    uint8_t     deviceCount;    // Per bus
+    uint32_t    periodMs;
+    DsMeasRes_t measRes;
+    bool        isFastRead;
+} BenchRun_t;
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const BenchRun_t benchRun[] = {
+    {1, 8, 1000, DS_MEAS_RES_12BIT, false},
+    {4, 32, 2000, DS_MEAS_RES_12BIT, false},
+    {4, 32, 1500, DS_MEAS_RES_10BIT, true},
+    {8, 32, 4000, DS_MEAS_RES_12BIT, false},
+    {8, 32, 2000, DS_MEAS_RES_12BIT, false},
+    {8, 32, 2000, DS_MEAS_RES_12BIT, true},
+    {8, 64, 6000, DS_MEAS_RES_11BIT, true}
+};
+
+static const char *resName[] = {"9bit", "10bit", "11bit", "12bit"};
+
+static DsSched_t sched;
+static DsSchedGroup_t group[BENCH_MAX_BUS_COUNT];
+static DsBus_t dsBus[BENCH_MAX_BUS_COUNT];
+static DsDevice_t device[BENCH_MAX_BUS_COUNT][BENCH_MAX_DEVICE_COUNT];
+static float tempData[BENCH_MAX_BUS_COUNT][BENCH_MAX_DEVICE_COUNT];
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static bool SetupBuses(const BenchRun_t *run);
+static void Report(const BenchRun_t *run, bool isOk, uint64_t elapsedNs, uint64_t maxTickNs);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("buses,devices,period_ms,res,read,ok,samples,errors,misses,mean_period_ms,min_period_ms,"
+           "max_period_ms,mean_jitter_ms,max_jitter_ms,max_latency_ms,bus_busy_pct,max_tick_ms\n");
+
+    for (uint8_t runIdx = 0; runIdx < sizeof(benchRun) / sizeof(benchRun[0]); runIdx++)
+    {
+        const BenchRun_t *run = &benchRun[runIdx];
+        bool isOk;
+
+        OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+        isOk = SetupBuses(run);
+
+        DS18B20_SchedInit(&sched);
+        for (uint8_t busIdx = 0; (busIdx < run->busCount) && isOk; busIdx++)
+        {
+            DsSchedConfig_t schedConfig = {
+                .bus = &dsBus[busIdx],
+                .device = device[busIdx],
+                .dataBuff = tempData[busIdx],
+                .deviceCount = run->deviceCount,
+                .periodMs = run->periodMs
+            };
+
+            isOk = DS18B20_SchedAddGroup(&sched, &group[busIdx], schedConfig);
+            DS18B20_ResetStats(&dsBus[busIdx], NULL, 0);
+        }
+
+        DS18B20_SchedStart(&sched);
+
+        /* Superloop */
+        uint64_t startNs = OWSIM_GetTimeNs();
+        uint64_t endNs = startNs + (uint64_t)run->periodMs * BENCH_PERIOD_COUNT * 1000000;
+        uint64_t maxTickNs = 0;
+
+        while (isOk && (OWSIM_GetTimeNs() < endNs))
+        {
+            uint64_t tickNs = OWSIM_GetTimeNs();
+
+            DS18B20_SchedTick(&sched);
+            tickNs = OWSIM_GetTimeNs() - tickNs;
+            maxTickNs = (tickNs > maxTickNs) ? tickNs : maxTickNs;
+
+            OWSIM_AdvanceUs(BENCH_LOOP_US);
+        }
+
+        Report(run, isOk, OWSIM_GetTimeNs() - startNs, maxTickNs);
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Attach devices to each bus, create their handles and set resolution
+ */
+static bool SetupBuses(const BenchRun_t *run)
+{
+    bool isOk = true;
+
+    for (uint8_t busIdx = 0; busIdx < run->busCount; busIdx++)
+    {
+        uint32_t pinCode = PIO_PIN_CODE(PIO_PORT_B, BENCH_FIRST_PIN + busIdx);
+
+        OWSIM_AddBus(pinCode, OW_STANDARD_SPEED);
+        for (uint8_t devIdx = 0; devIdx < run->deviceCount; devIdx++)
+        {
+            int32_t simIdx = OWSIM_AddDevice(pinCode, 0x005C4ED00000 + ((uint64_t)busIdx << 8) + devIdx);
+
+            OWSIM_SetTemp(simIdx, 20.0 + devIdx * 0.25);
+            isOk = DS18B20_InitDevice(&device[busIdx][devIdx], OWSIM_GetRomId(simIdx)) && isOk;
+        }
+
+        DsConfig_t dsConfig = {.measRes = run->measRes, .device = device[busIdx], .deviceCount = run->deviceCount};
+        isOk = DS18B20_InitBus(&dsBus[busIdx], (OwConfig_t){.pinCode = pinCode, .speedMode = OW_STANDARD_SPEED}) &&
+               DS18B20_ConfigDevice(&dsBus[busIdx], dsConfig, true) && isOk;
+        DS18B20_SetFastRead(&dsBus[busIdx], run->isFastRead);
+    }
+
+    return isOk;
+}
+
+
+/*
+ *  Print counters over all groups
+ */
+static void Report(const BenchRun_t *run, bool isOk, uint64_t elapsedNs, uint64_t maxTickNs)
+{
+    DsSchedStats_t total = {.minPeriodUs = UINT32_MAX};
+    uint32_t periodCount = 0;
+    uint64_t busyUs = 0;
+
+    for (uint8_t busIdx = 0; busIdx < run->busCount; busIdx++)
+    {
+        DsSchedStats_t stats;
+        DsStats_t busStats;
+
+        DS18B20_SchedGetStats(&group[busIdx], &stats);
+        total.startCount += stats.startCount;
+        total.sampleCount += stats.sampleCount;
+        total.errorCount += stats.errorCount;
+        total.missCount += stats.missCount;
+        total.periodSumUs += stats.periodSumUs;
+        total.jitterSumUs += stats.jitterSumUs;
+        total.minPeriodUs = (stats.minPeriodUs < total.minPeriodUs) ? stats.minPeriodUs : total.minPeriodUs;
+        total.maxPeriodUs = (stats.maxPeriodUs > total.maxPeriodUs) ? stats.maxPeriodUs : total.maxPeriodUs;
+        total.maxJitterUs = (stats.maxJitterUs > total.maxJitterUs) ? stats.maxJitterUs : total.maxJitterUs;
+        total.maxLatencyUs = (stats.maxLatencyUs > total.maxLatencyUs) ? stats.maxLatencyUs : total.maxLatencyUs;
+        periodCount += (stats.startCount > 0) ? stats.startCount - 1 : 0;
+
+        DS18B20_GetStats(&dsBus[busIdx], &busStats);
+        busyUs += busStats.busyUs;
+    }
+
+    printf("%u,%u,%u,%s,%s,%d,%u,%u,%u,%.2f,%.2f,%.2f,%.3f,%.3f,%.1f,%.1f,%.2f\n",
+           run->busCount, run->busCount * run->deviceCount, run->periodMs, resName[run->measRes],
+           run->isFastRead ? "fast" : "crc", isOk, total.sampleCount, total.errorCount, total.missCount,
+           (periodCount > 0) ? total.periodSumUs / 1000.0 / periodCount : 0.0,
+           (periodCount > 0) ? total.minPeriodUs / 1000.0 : 0.0, total.maxPeriodUs / 1000.0,
+           (total.startCount > 0) ? total.jitterSumUs / 1000.0 / total.startCount : 0.0,
+           total.maxJitterUs / 1000.0, total.maxLatencyUs / 1000.0,
+           busyUs * 100.0 / (elapsedNs / 1000.0) / run->busCount, maxTickNs / 1e6);
+}
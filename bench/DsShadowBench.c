@@ -0,0 +1,156 @@
+/*
+ *  Re-applied configuration on every boot, blind vs. shadowed writes
+ *
+ *  Eight simulated DS18B20 share one bus and keep their scratch-pad and
+ *  EEPROM across simulated reboots of the driver (new handles every boot).
+ *  Every boot applies the configuration of that boot and saves it to EEPROM,
+ *  either blindly (settings unknown, SKIP ROM write and copy) or after
+ *  DS18B20_LoadConfig, which lets unchanged writes and copies be skipped.
+ *  The "session" mode applies the same configurations without rebooting, so
+ *  the settings stay known from the previous step. One CSV row per step
+ *  reports the time taken (search excluded), the EEPROM write cycles spent
+ *  and whether EEPROM of all devices holds the configuration afterwards.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_DEVICE_COUNT      8
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+typedef struct {
+    DsMeasRes_t measRes;
+    int         highAlarm;
+    int         lowAlarm;
+} BenchBoot_t;
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/* Configuration applied on each boot (changed on first and fourth boot) */
+static const BenchBoot_t benchBoot[] = {
+    {DS_MEAS_RES_12BIT, 50, -10},
+    {DS_MEAS_RES_12BIT, 50, -10},
+    {DS_MEAS_RES_12BIT, 50, -10},
+    {DS_MEAS_RES_10BIT, 50, -10},
+    {DS_MEAS_RES_10BIT, 50, -10}
+};
+
+static const char *modeName[] = {"blind", "reboot_loaded", "session"};
+static const char *resName[] = {"9bit", "10bit", "11bit", "12bit"};
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static bool ApplyConfig(DsBus_t *bus, DsDevice_t *device, const BenchBoot_t *boot, bool isLoaded);
+static bool IsEepromOk(const DsDevice_t *device, const BenchBoot_t *boot);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("mode,step,res,ok,eeprom_ok,config_ms,eeprom_writes,write_skips\n");
+
+    for (uint8_t modeIdx = 0; modeIdx < sizeof(modeName) / sizeof(modeName[0]); modeIdx++)
+    {
+        DsDevice_t device[BENCH_DEVICE_COUNT];
+        DsBus_t dsBus;
+        bool isSession = (modeIdx == 2);
+
+        OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+        OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+        for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+        {
+            OWSIM_SetTemp(OWSIM_AddDevice(BENCH_PIN_CODE, 0x00005AD0E000 + devIdx), 20.0 + devIdx);
+        }
+
+        for (uint8_t bootIdx = 0; bootIdx < sizeof(benchBoot) / sizeof(benchBoot[0]); bootIdx++)
+        {
+            const BenchBoot_t *boot = &benchBoot[bootIdx];
+            OwSimStats_t simStats;
+            DsStats_t stats;
+            bool isOk = true;
+
+            /* Reboot: new bus context and handles, devices keep their memory */
+            if (!isSession || (bootIdx == 0))
+            {
+                DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+                isOk = (DS18B20_SearchDeviceId(&dsBus, device) == BENCH_DEVICE_COUNT);
+            }
+
+            OWSIM_ResetStats();
+            DS18B20_ResetStats(&dsBus, device, BENCH_DEVICE_COUNT);
+            isOk = isOk && ApplyConfig(&dsBus, device, boot, (modeIdx == 1) || (isSession && (bootIdx == 0)));
+            OWSIM_GetStats(&simStats);
+            DS18B20_GetStats(&dsBus, &stats);
+
+            printf("%s,%u,%s,%d,%d,%.2f,%u,%u\n",
+                   modeName[modeIdx], bootIdx, resName[boot->measRes], isOk,
+                   IsEepromOk(device, boot), simStats.timeNs / 1e6, simStats.eepromWriteCount,
+                   stats.writeSkipCount);
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Write configuration to all devices and save it to EEPROM (settings of
+ *  devices loaded first if "isLoaded")
+ */
+static bool ApplyConfig(DsBus_t *bus, DsDevice_t *device, const BenchBoot_t *boot, bool isLoaded)
+{
+    DsConfig_t dsConfig = {
+        .measRes = boot->measRes,
+        .device = device,
+        .deviceCount = BENCH_DEVICE_COUNT,
+        .highAlarm = boot->highAlarm,
+        .lowAlarm = boot->lowAlarm,
+        .isSaved = true
+    };
+
+    if (isLoaded && !DS18B20_LoadConfig(bus, device, BENCH_DEVICE_COUNT))
+    {
+        return false;
+    }
+
+    return DS18B20_ConfigDevice(bus, dsConfig, true);
+}
+
+
+/*
+ *  Check EEPROM of all devices (simulator index from lowest serial digit)
+ */
+static bool IsEepromOk(const DsDevice_t *device, const BenchBoot_t *boot)
+{
+    uint8_t eepromData[3];
+
+    for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+    {
+        OWSIM_GetEeprom(device[devIdx].romId & 0x0F, eepromData);
+        if ((eepromData[0] != boot->highAlarm) || (eepromData[1] != (0x80 | -boot->lowAlarm)) ||
+            ((eepromData[2] & 0x60) != (boot->measRes << 5)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
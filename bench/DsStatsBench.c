@@ -0,0 +1,115 @@
+/*
+ *  Bus and driver counters of DS18B20_GetStats under injected read errors
+ *
+ *  Four simulated DS18B20 share one bus. A search and several conversions
+ *  are run while single scratch-pad reads of chosen devices are corrupted.
+ *  Counters are cleared before each step, so every CSV row holds the counters
+ *  of that step alone (per-device CRC failures and validity of the last read
+ *  as "dev0/dev1/dev2/dev3"). Failed reads are repeated for that device only.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_DEVICE_COUNT      4
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static DsBus_t dsBus;
+static DsDevice_t device[BENCH_DEVICE_COUNT];
+static int32_t simIdx[BENCH_DEVICE_COUNT];
+static float tempData[BENCH_DEVICE_COUNT];
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void Report(const char *stepName, bool isOk);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    bool isOk;
+
+    printf("step,ok,resets,presence_fails,bits,crc_fails,retries,search_restarts,busy_us,max_masked_us,dev_crc_fails,dev_valid\n");
+
+    OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+    OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+    for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+    {
+        simIdx[devIdx] = OWSIM_AddDevice(BENCH_PIN_CODE, 0x00005747A000 + devIdx);
+        OWSIM_SetTemp(simIdx[devIdx], 20.0 + devIdx);
+    }
+    DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+
+    /* Search and configure (found in ROM order, simulator index by serial) */
+    isOk = (DS18B20_SearchDeviceId(&dsBus, device) == BENCH_DEVICE_COUNT);
+    for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+    {
+        simIdx[devIdx] = device[devIdx].romId & 0x0F;
+    }
+    Report("SearchDeviceId", isOk);
+
+    DsConfig_t dsConfig = {.measRes = DS_MEAS_RES_12BIT, .device = device, .deviceCount = BENCH_DEVICE_COUNT};
+    DS18B20_ResetStats(&dsBus, device, BENCH_DEVICE_COUNT);
+    Report("ConfigDevice", DS18B20_ConfigDevice(&dsBus, dsConfig, true));
+
+    /* Error-free cycle */
+    DS18B20_ResetStats(&dsBus, device, BENCH_DEVICE_COUNT);
+    Report("ConvertReadTemp", DS18B20_ConvertReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT));
+
+    /* One corrupted read, recovered by re-read */
+    DS18B20_ResetStats(&dsBus, device, BENCH_DEVICE_COUNT);
+    OWSIM_SetReadErrors(simIdx[1], 1);
+    Report("ConvertReadTemp_1err", DS18B20_ConvertReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT));
+
+    /* Corrupted reads on two devices */
+    DS18B20_ResetStats(&dsBus, device, BENCH_DEVICE_COUNT);
+    OWSIM_SetReadErrors(simIdx[0], 1);
+    OWSIM_SetReadErrors(simIdx[3], 1);
+    Report("ConvertReadTemp_2err", DS18B20_ConvertReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT));
+
+    /* Device failing every repeat */
+    DS18B20_ResetStats(&dsBus, device, BENCH_DEVICE_COUNT);
+    OWSIM_SetReadErrors(simIdx[2], DS_READ_RAM_REPEAT_COUNT);
+    Report("ConvertReadTemp_stuck", DS18B20_ConvertReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT));
+
+    /* Counters keep accumulating until reset */
+    DS18B20_ResetStats(&dsBus, device, BENCH_DEVICE_COUNT);
+    for (uint8_t cycleIdx = 0; cycleIdx < 10; cycleIdx++)
+    {
+        OWSIM_SetReadErrors(simIdx[cycleIdx % BENCH_DEVICE_COUNT], 1);
+        isOk = DS18B20_ConvertReadTemp(&dsBus, device, tempData, BENCH_DEVICE_COUNT);
+    }
+    Report("ConvertReadTemp_10x", isOk);
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+static void Report(const char *stepName, bool isOk)
+{
+    DsStats_t stats;
+    DS18B20_GetStats(&dsBus, &stats);
+
+    printf("%s,%d,%u,%u,%u,%u,%u,%u,%llu,%u,%u/%u/%u/%u,%d/%d/%d/%d\n",
+           stepName, isOk, stats.resetCount, stats.presenceFailCount, stats.bitCount,
+           stats.crcFailCount, stats.retryCount, stats.searchRestartCount,
+           (unsigned long long)stats.busyUs, stats.maxMaskedUs,
+           device[0].crcFailCount, device[1].crcFailCount, device[2].crcFailCount, device[3].crcFailCount,
+           device[0].isDataValid, device[1].isDataValid, device[2].isDataValid, device[3].isDataValid);
+}
@@ -0,0 +1,172 @@
+/*
+ *  CRC throughput of byte-wise and sliced LUT kernels
+ *
+ *  Each CRC config is generated byte-wise, sliced-by-4 and sliced-by-8 and
+ *  run over pseudo-random buffers from 64 B to 1 MB on the host CPU. One CSV
+ *  row per config and buffer size reports throughput and speedup against the
+ *  byte-wise kernel (ok - CRC equals byte-wise CRC of the same buffer).
+ */
+
+/** clock_gettime() with -std=c99 **/
+#define _POSIX_C_SOURCE 199309L
+
+/** Standard libs **/
+#include <stdio.h>
+#include <time.h>
+
+/** Custom libs **/
+#include "Edc.h"
+
+/** Benchmark parameters **/
+#define BENCH_MAX_BUFF_SIZE     (1UL << 20)
+#define BENCH_BYTES_PER_POINT   (32UL << 20)    // Data processed per measurement
+
+#if CRC_MAX_DEVICE_COUNT > 0
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+typedef struct {
+    const char      *name;
+    uint32_t        poly;
+    CrcPolySize_t   polySize;
+    bool            isReflected;
+} BenchCrc_t;
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const BenchCrc_t benchCrc[] = {
+    {"crc16-xmodem", 0x1021, CRC_POLY_SIZE_16, false},
+    {"crc16-arc", 0x8005, CRC_POLY_SIZE_16, true},
+    {"crc32", 0x04C11DB7, CRC_POLY_SIZE_32, true},
+};
+
+static const CrcSlicing_t benchSlicing[] = {CRC_SLICING_NONE, CRC_SLICING_4, CRC_SLICING_8};
+
+static const uint32_t benchBuffSize[] = {64, 256, 1024, 4096, 65536, BENCH_MAX_BUFF_SIZE};
+
+static uint8_t benchBuff[BENCH_MAX_BUFF_SIZE];
+
+/* Keeps results alive for the optimizer */
+static volatile uint32_t benchSink;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static double MeasureMbps(CrcHandle_t crcHandle, uint32_t buffSize);
+static double GetTimeSec(void);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    uint32_t seed = 0x12345678;
+
+    for (uint32_t idx = 0; idx < BENCH_MAX_BUFF_SIZE; idx++)
+    {
+        seed = seed * 1103515245 + 12345;
+        benchBuff[idx] = seed >> 24;
+    }
+
+    printf("crc,slicing,bytes,ok,mb_per_s,speedup\n");
+
+    for (uint8_t crcIdx = 0; crcIdx < sizeof(benchCrc) / sizeof(benchCrc[0]); crcIdx++)
+    {
+        CrcHandle_t crcHandle[sizeof(benchSlicing) / sizeof(benchSlicing[0])];
+
+        for (uint8_t sliceIdx = 0; sliceIdx < sizeof(benchSlicing) / sizeof(benchSlicing[0]); sliceIdx++)
+        {
+            CrcConfig_t crcConfig = {
+                .poly = benchCrc[crcIdx].poly,
+                .polySize = benchCrc[crcIdx].polySize,
+                .isInputReflected = benchCrc[crcIdx].isReflected,
+                .isCrcReflected = benchCrc[crcIdx].isReflected,
+                .slicing = benchSlicing[sliceIdx]
+            };
+
+            crcHandle[sliceIdx] = EDC_GenerateCrcLut(crcConfig);
+        }
+
+        /* Byte-wise kernel is the reference */
+        if (crcHandle[0] == NULL)
+        {
+            return 1;
+        }
+
+        for (uint8_t sizeIdx = 0; sizeIdx < sizeof(benchBuffSize) / sizeof(benchBuffSize[0]); sizeIdx++)
+        {
+            uint32_t buffSize = benchBuffSize[sizeIdx];
+            uint32_t refCrc = EDC_CalculateCrc(crcHandle[0], benchBuff, buffSize);
+            double refMbps = MeasureMbps(crcHandle[0], buffSize);
+
+            for (uint8_t sliceIdx = 0; sliceIdx < sizeof(benchSlicing) / sizeof(benchSlicing[0]); sliceIdx++)
+            {
+                /* Out of sliced LUTs (CRC_MAX_SLICED_COUNT) */
+                if (crcHandle[sliceIdx] == NULL)
+                {
+                    printf("%s,%u,%u,0,0,0\n", benchCrc[crcIdx].name, benchSlicing[sliceIdx], buffSize);
+                    continue;
+                }
+
+                bool isOk = (EDC_CalculateCrc(crcHandle[sliceIdx], benchBuff, buffSize) == refCrc);
+                double mbps = (sliceIdx == 0) ? refMbps : MeasureMbps(crcHandle[sliceIdx], buffSize);
+
+                printf("%s,%u,%u,%d,%.1f,%.2f\n", benchCrc[crcIdx].name, benchSlicing[sliceIdx], buffSize,
+                       isOk, mbps, mbps / refMbps);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Throughput in MB/s of CRC over first buffSize bytes of bench buffer
+ */
+static double MeasureMbps(CrcHandle_t crcHandle, uint32_t buffSize)
+{
+    uint32_t repeatCount = BENCH_BYTES_PER_POINT / buffSize;
+    double startSec = GetTimeSec();
+
+    for (uint32_t idx = 0; idx < repeatCount; idx++)
+    {
+        benchSink = EDC_CalculateCrc(crcHandle, benchBuff, buffSize);
+    }
+
+    return ((double)repeatCount * buffSize / 1e6) / (GetTimeSec() - startSec);
+}
+
+
+/*
+ *  Monotonic host time
+ */
+static double GetTimeSec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#else
+
+/* Runtime CRC LUTs compiled out - nothing to measure */
+int main(void)
+{
+    printf("crc,slicing,bytes,ok,mb_per_s,speedup\n");
+
+    return 0;
+}
+
+#endif  /* CRC_MAX_DEVICE_COUNT > 0 */
@@ -0,0 +1,140 @@
+/*
+ *  Slot timing with CPU call overhead, datasheet vs. calibrated delays
+ *
+ *  The simulated PIO and TMR stand-ins are given growing per-call costs. For
+ *  each cost model and speed mode four simulated DS18B20 are searched,
+ *  configured and read once with the raw AN126 delays and once after
+ *  OW_CalibrateTiming. One CSV row per run reports the measured overhead and
+ *  whether all temperatures were read correctly. Overhead beyond the shortest
+ *  slot delay (overdrive write-one LOW time) cannot be compensated.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_DEVICE_COUNT      4
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/* Per-call cost models (PIO access, delay set-up) */
+static const OwSimCost_t benchCost[] = {
+    {.pioNs = 0, .delayNs = 0, .counterNs = 100},
+    {.pioNs = 200, .delayNs = 500, .counterNs = 100},
+    {.pioNs = 400, .delayNs = 1000, .counterNs = 100},
+    {.pioNs = 500, .delayNs = 1500, .counterNs = 100},
+    {.pioNs = 1000, .delayNs = 3000, .counterNs = 100}
+};
+
+static const char *speedName[] = {
+    [OW_STANDARD_SPEED] = "standard",
+    [OW_HIGH_SPEED] = "high",
+    [OW_OVERLOAD_SPEED] = "overdrive"
+};
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static bool RunBench(DsBus_t *bus, OwSpeedMode_t speedMode);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("speed,pio_ns,delay_ns,delays,cal_pio_ns,cal_delay_ns,ok,elapsed_us\n");
+
+    for (uint8_t costIdx = 0; costIdx < sizeof(benchCost) / sizeof(benchCost[0]); costIdx++)
+    {
+        for (OwSpeedMode_t speedMode = OW_STANDARD_SPEED; speedMode <= OW_OVERLOAD_SPEED; speedMode++)
+        {
+            for (uint8_t isCalibrated = 0; isCalibrated <= 1; isCalibrated++)
+            {
+                OwSimStats_t stats;
+                DsBus_t dsBus;
+                bool isOk;
+
+                OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+                OWSIM_SetCost(benchCost[costIdx]);
+                OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+                for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+                {
+                    OWSIM_SetTemp(OWSIM_AddDevice(BENCH_PIN_CODE, 0x0000CA1B0000 + devIdx), 20.0 + devIdx);
+                }
+
+                DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+                if (isCalibrated)
+                {
+                    OW_CalibrateTiming(&dsBus.owBus);
+                }
+
+                OWSIM_ResetStats();
+                isOk = RunBench(&dsBus, speedMode);
+                OWSIM_GetStats(&stats);
+
+                printf("%s,%u,%u,%s,%u,%u,%d,%llu\n",
+                       speedName[speedMode], benchCost[costIdx].pioNs, benchCost[costIdx].delayNs,
+                       isCalibrated ? "calibrated" : "datasheet",
+                       dsBus.owBus.overhead.pioNs, dsBus.owBus.overhead.delayNs, isOk,
+                       (unsigned long long)(stats.timeNs / 1000));
+            }
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Search devices (standard speed), then configure and read them at speed
+ *  mode under test
+ */
+static bool RunBench(DsBus_t *bus, OwSpeedMode_t speedMode)
+{
+    DsDevice_t device[BENCH_DEVICE_COUNT];
+    float tempData[BENCH_DEVICE_COUNT];
+    DsConfig_t dsConfig = {
+        .measRes = DS_MEAS_RES_12BIT,
+        .device = device,
+        .deviceCount = BENCH_DEVICE_COUNT,
+        .highAlarm = 40,
+        .lowAlarm = 10
+    };
+
+    if (DS18B20_SearchDeviceId(bus, device) != BENCH_DEVICE_COUNT)
+    {
+        return false;
+    }
+
+    OW_ConfigSpeedMode(&bus->owBus, speedMode);
+    OWSIM_SetSpeedMode(BENCH_PIN_CODE, speedMode);
+
+    if (!DS18B20_ConfigDevice(bus, dsConfig, false) ||
+        !DS18B20_ConvertReadTemp(bus, device, tempData, BENCH_DEVICE_COUNT))
+    {
+        return false;
+    }
+
+    /* Temperature was set from lowest serial number digit */
+    for (uint8_t devIdx = 0; devIdx < BENCH_DEVICE_COUNT; devIdx++)
+    {
+        if (tempData[devIdx] != (float)(20.0 + (device[devIdx].romId & 0x0F)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
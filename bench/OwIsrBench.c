@@ -0,0 +1,173 @@
+/*
+ *  CPU load of bit-banged, timer-interrupt-driven and UART-driven OneWire
+ *  transfers
+ *
+ *  A single scratch-pad read (reset, MATCH ROM, READ SCRATCHPAD, 9 bytes) is
+ *  done with OneWire.c, with OneWireIsr.c driven by the simulated timer and
+ *  with OneWireUart.c on the simulated UART loopback. One CSV row per
+ *  transport and speed mode reports elapsed bus time, CPU time taken from the
+ *  application and interrupt-masked time.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OneWireIsr.h"
+#include "OneWireUart.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_ISR_COST_NS       1000    // ISR entry and exit at 40 MHz
+#define BENCH_PIO_COST_NS       100
+#define BENCH_UART_COST_NS      2000    // DMA set-up per exchange at 40 MHz
+#define BENCH_IDLE_STEP_US      10      // Granularity of application work
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const char *speedName[] = {
+    [OW_STANDARD_SPEED] = "standard",
+    [OW_HIGH_SPEED] = "high",
+    [OW_OVERLOAD_SPEED] = "overdrive"
+};
+
+static volatile bool isIsrDone;
+static volatile bool isIsrPresent;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void ResetDone(void *context, bool isOk);
+static void ReadDone(void *context, bool isOk);
+static void Report(const char *transport, OwSpeedMode_t speedMode, bool isOk, uint64_t cpuNs);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("transport,speed,ok,elapsed_us,cpu_us,masked_us,max_masked_us,isr_count\n");
+
+    for (OwSpeedMode_t speedMode = OW_STANDARD_SPEED; speedMode <= OW_OVERLOAD_SPEED; speedMode++)
+    {
+        OwSimCost_t cost = {.pioNs = BENCH_PIO_COST_NS, .counterNs = 100, .isrNs = BENCH_ISR_COST_NS,
+                            .uartNs = BENCH_UART_COST_NS};
+        DsBus_t dsBus;
+        OwBus_t *owBus = &dsBus.owBus;
+        DsDevice_t device;
+        uint8_t bbData[9], isrData[9], uartData[9];
+        uint8_t txData[10];
+
+        OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+        OWSIM_SetCost(cost);
+        OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+        OWSIM_SetTemp(OWSIM_AddDevice(BENCH_PIN_CODE, 0x0000DEADBEEF), 21.5);
+
+        DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+        if (DS18B20_SearchDeviceId(&dsBus, &device) != 1)
+        {
+            return 1;
+        }
+        OW_ConfigSpeedMode(owBus, speedMode);
+        OWSIM_SetSpeedMode(BENCH_PIN_CODE, speedMode);
+
+        /* MATCH ROM frame + READ SCRATCHPAD */
+        txData[0] = 0x55;
+        memcpy(&txData[1], &device.romFrame, 8);
+        txData[9] = 0xBE;
+
+        /* Bit-banged transfer blocks the CPU for the whole time */
+        OWSIM_ResetStats();
+        bool isOk = OW_Reset(owBus);
+        OW_WriteMultiByte(owBus, txData, sizeof(txData));
+        OW_ReadMultiByte(owBus, bbData, sizeof(bbData));
+        isOk = isOk && (EDC_CalculateCrc8Maxim(bbData, 9) == 0);
+        OwSimStats_t stats;
+        OWSIM_GetStats(&stats);
+        Report("bitbang", speedMode, isOk, stats.timeNs);
+
+        /* ISR transfer: application keeps running between slot edges */
+        OWSIM_SetTimerIsr(OW_IsrService);
+        OW_IsrConfig(owBus, OWSIM_ArmTimerUs);
+        isIsrDone = false;
+
+        OWSIM_ResetStats();
+        OW_IsrQueueReset(ResetDone, NULL);
+        OW_IsrQueueWrite(txData, sizeof(txData), NULL, NULL);
+        OW_IsrQueueRead(isrData, sizeof(isrData), ReadDone, NULL);
+        while (!isIsrDone)
+        {
+            OWSIM_AdvanceUs(BENCH_IDLE_STEP_US);
+        }
+        isOk = isIsrPresent && (memcmp(bbData, isrData, sizeof(isrData)) == 0);
+        OWSIM_GetStats(&stats);
+        Report("isr", speedMode, isOk, stats.isrNs);
+        OWSIM_SetTimerIsr(NULL);
+
+        /* UART transfer: CPU only sets up one exchange per reset or chunk */
+        OwBus_t uartBus;
+        OwUart_t uart;
+        OwUartPort_t uartPort = {.setBaud = OWSIM_UartSetBaud, .exchange = OWSIM_UartExchange};
+        OW_ConfigBus(&uartBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = speedMode});
+        OWSIM_AttachUart(BENCH_PIN_CODE);
+        OW_UartConfig(&uartBus, &uart, uartPort);
+
+        OWSIM_ResetStats();
+        isOk = OW_Reset(&uartBus);
+        OW_WriteMultiByte(&uartBus, txData, sizeof(txData));
+        OW_ReadMultiByte(&uartBus, uartData, sizeof(uartData));
+        isOk = isOk && (memcmp(bbData, uartData, sizeof(uartData)) == 0);
+        OWSIM_GetStats(&stats);
+        Report("uart", speedMode, isOk, stats.uartNs);
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Reset completion (presence)
+ */
+static void ResetDone(void *context, bool isOk)
+{
+    (void)context;
+    isIsrPresent = isOk;
+}
+
+
+/*
+ *  Read completion (end of transfer)
+ */
+static void ReadDone(void *context, bool isOk)
+{
+    (void)context;
+    isIsrDone = isOk;
+}
+
+
+/*
+ *  Print one CSV row with counters accumulated since last reset
+ */
+static void Report(const char *transport, OwSpeedMode_t speedMode, bool isOk, uint64_t cpuNs)
+{
+    OwSimStats_t stats;
+    OWSIM_GetStats(&stats);
+
+    printf("%s,%s,%d,%llu,%llu,%llu,%llu,%u\n",
+           transport, speedName[speedMode], isOk,
+           (unsigned long long)(stats.timeNs / 1000),
+           (unsigned long long)(cpuNs / 1000),
+           (unsigned long long)(stats.maskedNs / 1000),
+           (unsigned long long)(stats.maxMaskedNs / 1000),
+           stats.isrCount);
+}
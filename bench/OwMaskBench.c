@@ -0,0 +1,132 @@
+/*
+ *  Worst-case interrupt-masked time per OW_* call
+ *
+ *  Each public OneWire transfer function is run against one simulated DS18B20
+ *  in every speed mode, once with legacy whole-transfer masking and once per
+ *  latency-bounded window (OW_ConfigMaxMasked). One CSV row per call reports
+ *  elapsed time, total and longest continuous interrupt-masked time.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_PIO_COST_NS       100
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+/* Max. masked window in us (0 - legacy whole-transfer masking) */
+static const uint16_t benchMaskWindow[] = {0, 1, 100, 500};
+
+static const char *speedName[] = {
+    [OW_STANDARD_SPEED] = "standard",
+    [OW_HIGH_SPEED] = "high",
+    [OW_OVERLOAD_SPEED] = "overdrive"
+};
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void Report(const char *opName, OwSpeedMode_t speedMode, uint16_t maskWindow, bool isOk);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("op,speed,mask_window_us,ok,elapsed_us,masked_us,max_masked_us\n");
+
+    for (OwSpeedMode_t speedMode = OW_STANDARD_SPEED; speedMode <= OW_OVERLOAD_SPEED; speedMode++)
+    {
+        for (uint8_t winIdx = 0; winIdx < sizeof(benchMaskWindow) / sizeof(benchMaskWindow[0]); winIdx++)
+        {
+            OwSimCost_t cost = {.pioNs = BENCH_PIO_COST_NS};
+            uint16_t maskWindow = benchMaskWindow[winIdx];
+            DsDevice_t device;
+            uint8_t txData[10], rxData[9];
+            bool isOk;
+
+            OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+            OWSIM_SetCost(cost);
+            OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+            OWSIM_SetTemp(OWSIM_AddDevice(BENCH_PIN_CODE, 0x0000DEADBEEF), 21.5);
+
+            DsBus_t dsBus;
+            OwBus_t *owBus = &dsBus.owBus;
+            DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+            if (DS18B20_SearchDeviceId(&dsBus, &device) != 1)
+            {
+                return 1;
+            }
+            OW_ConfigSpeedMode(owBus, speedMode);
+            OWSIM_SetSpeedMode(BENCH_PIN_CODE, speedMode);
+            OW_ConfigMaxMasked(owBus, maskWindow);
+
+            /* MATCH ROM frame + READ SCRATCHPAD */
+            txData[0] = 0x55;
+            memcpy(&txData[1], &device.romFrame, 8);
+            txData[9] = 0xBE;
+
+            OWSIM_ResetStats();
+            isOk = OW_Reset(owBus);
+            Report("Reset", speedMode, maskWindow, isOk);
+
+            OWSIM_ResetStats();
+            OW_WriteByte(owBus, txData[0]);
+            Report("WriteByte", speedMode, maskWindow, true);
+
+            OWSIM_ResetStats();
+            OW_WriteMultiByte(owBus, &txData[1], sizeof(txData) - 1);
+            Report("WriteMultiByte", speedMode, maskWindow, true);
+
+            OWSIM_ResetStats();
+            OW_ReadByte(owBus, &rxData[0]);
+            Report("ReadByte", speedMode, maskWindow, true);
+
+            OWSIM_ResetStats();
+            OW_ReadMultiByte(owBus, &rxData[1], sizeof(rxData) - 1);
+            isOk = (EDC_CalculateCrc8Maxim(rxData, sizeof(rxData)) == 0);
+            Report("ReadMultiByte", speedMode, maskWindow, isOk);
+
+            /* Single slots (device idle after scratchpad read - reads back ones) */
+            OWSIM_ResetStats();
+            OW_WriteBit(owBus, 0);
+            Report("WriteBit", speedMode, maskWindow, true);
+
+            OWSIM_ResetStats();
+            isOk = (OW_ReadBit(owBus) == 1);
+            Report("ReadBit", speedMode, maskWindow, isOk);
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Print one CSV row with counters accumulated since last reset
+ */
+static void Report(const char *opName, OwSpeedMode_t speedMode, uint16_t maskWindow, bool isOk)
+{
+    OwSimStats_t stats;
+    OWSIM_GetStats(&stats);
+
+    printf("%s,%s,%u,%d,%llu,%llu,%.1f\n",
+           opName, speedName[speedMode], maskWindow, isOk,
+           (unsigned long long)(stats.timeNs / 1000),
+           (unsigned long long)(stats.maskedNs / 1000),
+           stats.maxMaskedNs / 1000.0);
+}
@@ -0,0 +1,207 @@
+/*
+ *  Sequential vs. lockstep access of several OneWire buses on one port
+ *
+ *  One simulated DS18B20 is attached to each of 1, 2, 4 and 8 buses. Reset,
+ *  temperature conversion and scratch-pad read are run bus after bus
+ *  (single-pin functions) and on all buses at once (pin group). One CSV row
+ *  per operation reports totals over all buses.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+
+/** Benchmark parameters **/
+#define BENCH_MAX_BUS_COUNT     8
+#define BENCH_FIRST_PIN         5       // Buses on RB5 and up
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const uint8_t benchBusCount[] = {1, 2, 4, 8};
+
+static const char *speedName[] = {
+    [OW_STANDARD_SPEED] = "standard",
+    [OW_HIGH_SPEED] = "high",
+    [OW_OVERLOAD_SPEED] = "overdrive"
+};
+
+static DsBus_t singleBus[BENCH_MAX_BUS_COUNT];
+static DsBus_t groupBus;
+static DsDevice_t device[BENCH_MAX_BUS_COUNT];
+static float tempData[BENCH_MAX_BUS_COUNT];
+static OwSimStats_t totalStats;
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void ConfigBus(DsBus_t *bus, uint32_t pinCode, OwSpeedMode_t speedMode, DsDevice_t *dev, uint8_t busCount);
+static void AddStats(void);
+static bool IsTempValid(uint8_t busCount);
+static void Report(const char *opName, OwSpeedMode_t speedMode, uint8_t busCount, const char *modeName, bool isOk);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(void)
+{
+    printf("op,speed,buses,mode,ok,elapsed_us,masked_us,max_masked_us,resets,slots\n");
+
+    for (uint8_t cntIdx = 0; cntIdx < sizeof(benchBusCount) / sizeof(benchBusCount[0]); cntIdx++)
+    {
+        uint8_t busCount = benchBusCount[cntIdx];
+
+        for (OwSpeedMode_t speedMode = OW_STANDARD_SPEED; speedMode <= OW_OVERLOAD_SPEED; speedMode++)
+        {
+            uint32_t busPin[BENCH_MAX_BUS_COUNT];
+            uint32_t pinGroup = 0;
+            bool isOk;
+
+            OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+
+            for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+            {
+                busPin[busIdx] = PIO_PIN_CODE(PIO_PORT_B, BENCH_FIRST_PIN + busIdx);
+                pinGroup |= busPin[busIdx];
+
+                OWSIM_AddBus(busPin[busIdx], speedMode);
+                int32_t devIdx = OWSIM_AddDevice(busPin[busIdx], 0x00C0FFEE0000 + busIdx);
+                OWSIM_SetTemp(devIdx, 20.0 + busIdx);
+                DS18B20_InitDevice(&device[busIdx], OWSIM_GetRomId(devIdx));
+                ConfigBus(&singleBus[busIdx], busPin[busIdx], speedMode, &device[busIdx], 1);
+            }
+
+            /* Bus after bus (one context per bus) */
+            totalStats = (OwSimStats_t){0};
+            isOk = true;
+            for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+            {
+                OWSIM_ResetStats();
+                isOk &= OW_Reset(&singleBus[busIdx].owBus);
+                AddStats();
+            }
+            Report("Reset", speedMode, busCount, "sequential", isOk);
+
+            totalStats = (OwSimStats_t){0};
+            isOk = true;
+            for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+            {
+                OWSIM_ResetStats();
+                isOk &= DS18B20_ConvertTemp(&singleBus[busIdx], &device[busIdx], 1);
+                AddStats();
+            }
+            Report("ConvertTemp", speedMode, busCount, "sequential", isOk);
+
+            OWSIM_AdvanceUs(800000);
+            totalStats = (OwSimStats_t){0};
+            isOk = true;
+            for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+            {
+                OWSIM_ResetStats();
+                isOk &= DS18B20_ReadTemp(&singleBus[busIdx], &device[busIdx], &tempData[busIdx], 1);
+                AddStats();
+            }
+            Report("ReadTemp", speedMode, busCount, "sequential", isOk && IsTempValid(busCount));
+
+            /* All buses at once (one context for the pin group) */
+            ConfigBus(&groupBus, pinGroup, speedMode, device, busCount);
+
+            totalStats = (OwSimStats_t){0};
+            OWSIM_ResetStats();
+            isOk = (OW_MultiReset(&groupBus.owBus) == PIO_PIN_MASK(pinGroup));
+            AddStats();
+            Report("Reset", speedMode, busCount, "lockstep", isOk);
+
+            /* SKIP ROM on every bus (MATCH ROM if single bus) */
+            totalStats = (OwSimStats_t){0};
+            OWSIM_ResetStats();
+            isOk = DS18B20_ConvertTemp(&groupBus, device, busCount);
+            AddStats();
+            Report("ConvertTemp", speedMode, busCount, "lockstep", isOk);
+
+            OWSIM_AdvanceUs(800000);
+            for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+            {
+                tempData[busIdx] = 0;
+            }
+            totalStats = (OwSimStats_t){0};
+            OWSIM_ResetStats();
+            isOk = DS18B20_ReadTempMulti(&groupBus, device, tempData);
+            AddStats();
+            Report("ReadTemp", speedMode, busCount, "lockstep", isOk && IsTempValid(busCount));
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Set up bus (or pin group) context and configure its devices
+ */
+static void ConfigBus(DsBus_t *bus, uint32_t pinCode, OwSpeedMode_t speedMode, DsDevice_t *dev, uint8_t busCount)
+{
+    DsConfig_t dsConfig = {
+        .measRes = DS_MEAS_RES_12BIT,
+        .device = dev,
+        .deviceCount = busCount,
+        .highAlarm = 40,
+        .lowAlarm = 10
+    };
+
+    DS18B20_InitBus(bus, (OwConfig_t){.pinCode = pinCode, .speedMode = speedMode});
+    DS18B20_ConfigDevice(bus, dsConfig, (busCount > 1));
+}
+
+
+/*
+ *  Accumulate counters of last measured call
+ */
+static void AddStats(void)
+{
+    OwSimStats_t stats;
+    OWSIM_GetStats(&stats);
+
+    totalStats.timeNs += stats.timeNs;
+    totalStats.maskedNs += stats.maskedNs;
+    totalStats.maxMaskedNs = (stats.maxMaskedNs > totalStats.maxMaskedNs) ? stats.maxMaskedNs : totalStats.maxMaskedNs;
+    totalStats.resetCount += stats.resetCount;
+    totalStats.slotCount += stats.slotCount;
+}
+
+
+/*
+ *  Check read temperatures against simulated ones
+ */
+static bool IsTempValid(uint8_t busCount)
+{
+    for (uint8_t busIdx = 0; busIdx < busCount; busIdx++)
+    {
+        if (tempData[busIdx] != (float)(20.0 + busIdx))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void Report(const char *opName, OwSpeedMode_t speedMode, uint8_t busCount, const char *modeName, bool isOk)
+{
+    printf("%s,%s,%u,%s,%d,%llu,%llu,%llu,%u,%u\n",
+           opName, speedName[speedMode], busCount, modeName, isOk,
+           (unsigned long long)(totalStats.timeNs / 1000),
+           (unsigned long long)(totalStats.maskedNs / 1000),
+           (unsigned long long)(totalStats.maxMaskedNs / 1000),
+           totalStats.resetCount, totalStats.slotCount);
+}
@@ -0,0 +1,228 @@
+/*
+ *  Slot timing measured from OneWire trace (OW_ConfigTrace)
+ *
+ *  A reset, MATCH ROM and scratch-pad read of one simulated DS18B20 are
+ *  traced in every speed mode. One CSV row per speed mode reports the slot
+ *  timing measured from the recorded edges (to compare against datasheet
+ *  windows) and the shortest recovery time between slots. If an output
+ *  directory is passed, each trace is also written as <dir>/OwTrace_<speed>.vcd
+ *  for viewing in GTKWave.
+ */
+
+/** Standard libs **/
+#include <stdio.h>
+#include <string.h>
+
+/** Custom libs **/
+#include "ds18b20.h"
+#include "OwSim.h"
+#include "OwVcd.h"
+
+/** Benchmark parameters **/
+#define BENCH_PIN_CODE          GPIO_RPB5
+#define BENCH_PIO_COST_NS       100
+#define BENCH_TRACE_SIZE        1024
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+/** Slot timing extremes (ns) **/
+typedef struct {
+    uint64_t    resetLowNs;
+    uint64_t    presenceSampleNs;   // After reset pulse release
+    uint64_t    oneLowMaxNs;
+    uint64_t    zeroLowMinNs;
+    uint64_t    readSampleMaxNs;    // After slot start
+    uint64_t    slotMinNs;
+    uint64_t    slotMaxNs;
+    uint64_t    recoveryMinNs;
+} SlotTiming_t;
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static const char *speedName[] = {
+    [OW_STANDARD_SPEED] = "standard",
+    [OW_HIGH_SPEED] = "high",
+    [OW_OVERLOAD_SPEED] = "overdrive"
+};
+
+static OwTraceEvent_t traceEvent[BENCH_TRACE_SIZE];
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void MeasureSlots(const OwTrace_t *trace, const OwDelay_t *owDelay, SlotTiming_t *timing);
+static uint64_t TicksToNs(uint32_t coreTicks);
+
+/******************************************************************************/
+/*-------------------------------Main Function--------------------------------*/
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    printf("speed,ok,events,lost,reset_low_us,presence_sample_us,one_low_max_us,zero_low_min_us,"
+           "read_sample_max_us,slot_min_us,slot_max_us,recovery_min_us\n");
+
+    for (OwSpeedMode_t speedMode = OW_STANDARD_SPEED; speedMode <= OW_OVERLOAD_SPEED; speedMode++)
+    {
+        OwSimCost_t cost = {.pioNs = BENCH_PIO_COST_NS, .counterNs = 100};
+        SlotTiming_t timing;
+        DsDevice_t device;
+        OwTrace_t trace;
+        uint8_t txData[10], rxData[9];
+        bool isOk;
+
+        OWSIM_Init(OWSIM_DEFAULT_SYSFREQ);
+        OWSIM_SetCost(cost);
+        OWSIM_AddBus(BENCH_PIN_CODE, OW_STANDARD_SPEED);
+        OWSIM_SetTemp(OWSIM_AddDevice(BENCH_PIN_CODE, 0x000075ACE000), 21.5);
+
+        DsBus_t dsBus;
+        OwBus_t *owBus = &dsBus.owBus;
+        DS18B20_InitBus(&dsBus, (OwConfig_t){.pinCode = BENCH_PIN_CODE, .speedMode = OW_STANDARD_SPEED});
+        if (DS18B20_SearchDeviceId(&dsBus, &device) != 1)
+        {
+            return 1;
+        }
+        OW_ConfigSpeedMode(owBus, speedMode);
+        OWSIM_SetSpeedMode(BENCH_PIN_CODE, speedMode);
+
+        /* Trace reset + MATCH ROM + READ SCRATCHPAD */
+        txData[0] = 0x55;
+        memcpy(&txData[1], &device.romFrame, 8);
+        txData[9] = 0xBE;
+
+        OW_ConfigTrace(owBus, &trace, traceEvent, BENCH_TRACE_SIZE);
+        isOk = OW_Reset(owBus);
+        OW_WriteMultiByte(owBus, txData, 10);
+        OW_ReadMultiByte(owBus, rxData, 9);
+        OW_ConfigTrace(owBus, NULL, NULL, 0);
+        isOk = isOk && (EDC_CalculateCrc8Maxim(rxData, 9) == 0);
+
+        MeasureSlots(&trace, OW_GetDelay(owBus), &timing);
+
+        printf("%s,%d,%u,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+               speedName[speedMode], isOk, trace.count, trace.lostCount,
+               timing.resetLowNs / 1000.0, timing.presenceSampleNs / 1000.0,
+               timing.oneLowMaxNs / 1000.0, timing.zeroLowMinNs / 1000.0,
+               timing.readSampleMaxNs / 1000.0, timing.slotMinNs / 1000.0,
+               timing.slotMaxNs / 1000.0, timing.recoveryMinNs / 1000.0);
+
+        if (argc > 1)
+        {
+            char fileName[256];
+
+            snprintf(fileName, sizeof(fileName), "%s/OwTrace_%s.vcd", argv[1], speedName[speedMode]);
+            if (!OWVCD_WriteTrace(fileName, &trace, BENCH_PIN_CODE, OSC_GetSysFreq()))
+            {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Walk pull/release/sample events of a single bus - LOW pulses longer than
+ *  twice "c" are resets, slots with a sample are read slots and the other
+ *  slots are told apart by LOW time (write one or write zero)
+ */
+static void MeasureSlots(const OwTrace_t *trace, const OwDelay_t *owDelay, SlotTiming_t *timing)
+{
+    uint64_t pullNs = 0, releaseNs = 0, lastPullNs = 0;
+    uint64_t resetThresNs = owDelay->c * 2000ULL;
+    uint64_t oneThresNs = (owDelay->a + owDelay->c) * 500ULL;
+    uint64_t elapsedNs = 0;
+    uint32_t lastTick = 0;
+    bool isReset = false, isSlotOpen = false, isRead = false;
+
+    *timing = (SlotTiming_t){.zeroLowMinNs = UINT64_MAX, .slotMinNs = UINT64_MAX, .recoveryMinNs = UINT64_MAX};
+
+    for (uint16_t eventIdx = 0; eventIdx < trace->count; eventIdx++)
+    {
+        const OwTraceEvent_t *event = OW_GetTraceEvent(trace, eventIdx);
+        uint64_t lowNs;
+
+        elapsedNs += (eventIdx == 0) ? 0 : TicksToNs(event->tick - lastTick);
+        lastTick = event->tick;
+
+        switch (event->type)
+        {
+            case OW_TRACE_PULL:
+                /* Close previous slot (reset recovery not counted) */
+                if (isSlotOpen && !isReset)
+                {
+                    uint64_t slotNs = elapsedNs - lastPullNs;
+                    uint64_t recNs = elapsedNs - releaseNs;
+
+                    timing->slotMinNs = (slotNs < timing->slotMinNs) ? slotNs : timing->slotMinNs;
+                    timing->slotMaxNs = (slotNs > timing->slotMaxNs) ? slotNs : timing->slotMaxNs;
+                    timing->recoveryMinNs = (recNs < timing->recoveryMinNs) ? recNs : timing->recoveryMinNs;
+                }
+                pullNs = elapsedNs;
+                lastPullNs = elapsedNs;
+                isSlotOpen = true;
+                isRead = false;
+                break;
+
+            case OW_TRACE_RELEASE:
+                releaseNs = elapsedNs;
+                lowNs = releaseNs - pullNs;
+                isReset = (lowNs > resetThresNs);
+                if (isReset)
+                {
+                    timing->resetLowNs = lowNs;
+                }
+                break;
+
+            case OW_TRACE_SAMPLE:
+                if (isReset)
+                {
+                    timing->presenceSampleNs = elapsedNs - releaseNs;
+                }
+                else
+                {
+                    uint64_t sampleNs = elapsedNs - pullNs;
+
+                    timing->readSampleMaxNs = (sampleNs > timing->readSampleMaxNs) ? sampleNs : timing->readSampleMaxNs;
+                    isRead = true;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        /* Write slot LOW time known once slot is released */
+        if ((event->type == OW_TRACE_RELEASE) && !isReset && !isRead)
+        {
+            lowNs = releaseNs - pullNs;
+            if (lowNs < oneThresNs)
+            {
+                timing->oneLowMaxNs = (lowNs > timing->oneLowMaxNs) ? lowNs : timing->oneLowMaxNs;
+            }
+            else
+            {
+                timing->zeroLowMinNs = (lowNs < timing->zeroLowMinNs) ? lowNs : timing->zeroLowMinNs;
+            }
+        }
+    }
+}
+
+
+/*
+ *  Core timer ticks (SYSCLK/2) to nanoseconds
+ */
+static uint64_t TicksToNs(uint32_t coreTicks)
+{
+    return ((uint64_t)coreTicks * 2000000000ULL) / OSC_GetSysFreq();
+}
@@ -1,12 +1,8 @@
-#include "DS18B20.h"
+#include "ds18b20.h"
 
 /** DS18B20 Family Code **/
 #define DS18B20_FAMILY_CODE     0x28   // Code 0x10 for DS18S20 (not supported)
 
-/** DS18B20 CRC Polynomial **/
-#define CRC_POLY_SIZE           8
-#define CRC_POLY_CODE           0x31
-
 /** DS18B20 ROM Commands **/
 #define SEARCH_ROM_CMD          0xF0
 #define READ_ROM_CMD            0x33
@@ -26,16 +22,38 @@
 #define MAX_TEMP                127
 #define MIN_TEMP               -55
 
+/** Datasheet max. conversion time at 9-bit resolution (doubles per bit) **/
+#define CONV_TEMP_9BIT_US       93750
+
+/** Reserved scratch-pad bytes 5 and 7 (fixed values of genuine devices) **/
+#define RESERVED_BYTE5          0xFF
+#define RESERVED_BYTE7          0x10
+
+/** Datasheet max. EEPROM write time (parasite powered copy) **/
+#define COPY_MEM_US             10000
+
+/** Configuration register: resolution bits, other bits always read as 0/1 **/
+#define CONFIG_RES_MASK         0x60
+#define CONFIG_FIXED_BITS       0x1F
+
+/** Raw temperature register value after power-on (85 degC) **/
+#define POWER_ON_TEMP_RAW       0x0550
+
+/** Raw temperature read from a device that does not respond (-0.0625 degC) **/
+#define ALL_ONES_TEMP_RAW       0xFFFF
+
+/** SYSCLK assumed if bus was set up without it **/
+#define DEFAULT_SYSFREQ         8000000
+
 /******************************************************************************/
 /*--------------------------Local Data Structures-----------------------------*/
 /******************************************************************************/
 
-/** Static structure **/
-static struct {
-    uint32_t            sysFreq;
-    uint32_t            owPinCode;
-    float               tempCorr;
-} statVar;
+/** Scratch-pad read in progress (CRC updated as bytes arrive) **/
+typedef struct {
+    uint8_t             crcVal;
+    uint8_t             byteIdx;
+} ScratchpadRead_t;
 
 /** Enumeration types **/
 typedef enum {SEARCH_DEVICE_ID, SEARCH_DEVICE_ALARM } SearchMode_t;
@@ -45,162 +63,492 @@ typedef enum {SAVE_ROM_MODE, COPY_ROM_MODE} RomMode_t;
 /*------------------------Local Function Prototypes---------------------------*/
 /******************************************************************************/
 
-static uint32_t SearchDevice(const uint32_t pinCode, uint64_t *romIdBuff, SearchMode_t searchMode);
-static bool GenerateCrcLut(void);
-static bool ConfigDevice(DsConfig_t dsConfig, bool isMultiMode);
-static bool SaveCopyRom(const uint64_t *romId, bool isMultiMode, RomMode_t romMode);
+static uint32_t SearchDevice(DsBus_t *bus, DsDevice_t *deviceBuff, SearchMode_t searchMode);
+static bool StartSearch(DsBus_t *bus, DsSearchJob_t *job, DsDevice_t *deviceBuff, SearchMode_t searchMode);
+static bool SearchRom(DsSearchJob_t *job, uint64_t *romData, int *lastZero);
+static void FinishSearch(DsSearchJob_t *job, DsConvState_t state);
+static bool ConfigDevice(DsBus_t *bus, DsConfig_t dsConfig, bool isMultiMode);
+static bool SaveConfig(DsBus_t *bus, DsConfig_t dsConfig, bool isMultiMode);
+static void StartSaveConfig(DsBus_t *bus, DsRomJob_t *job, DsConfig_t dsConfig, bool isMultiMode);
+static bool SaveCopyRom(DsBus_t *bus, DsDevice_t *device, bool isMultiMode, RomMode_t romMode);
+static void StartRomJob(DsBus_t *bus, DsRomJob_t *job, DsDevice_t *device, bool isMultiMode, RomMode_t romMode);
+static void InitRomJob(DsBus_t *bus, DsRomJob_t *job, RomMode_t romMode);
+static void StartTransfer(DsRomJob_t *job, DsDevice_t *device, bool isMultiMode);
+static void PollTransfer(DsRomJob_t *job);
+static void NextTransfer(DsRomJob_t *job);
+static bool WaitRomJob(DsRomJob_t *job);
+static bool WriteScratchpad(DsBus_t *bus, DsDevice_t *device, uint8_t hiAlarm, uint8_t loAlarm, uint8_t config);
+static bool ReadScratchpad(DsBus_t *bus, uint8_t *rxData);
+static bool ScratchpadByteHook(void *context, uint8_t dataByte);
+static bool ReadDeviceRam(DsBus_t *bus, DsDevice_t *device, uint8_t *rxData, uint8_t repeatCount);
+static bool ReadTempFast(DsBus_t *bus, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount);
+static bool IsTempPlausible(const uint8_t *rxData);
+static float RawToCelsius(const DsBus_t *bus, const uint8_t *rxData);
+static INLINE void MatchRom(DsBus_t *bus, const DsDevice_t *device);
+static INLINE bool IsDeviceValid(const DsDevice_t *device);
+static bool IsReadSkipped(DsBus_t *bus, DsDevice_t *device);
+static INLINE uint8_t GetRepeatCount(const DsDevice_t *device);
+static void UpdateHealth(DsBus_t *bus, DsDevice_t *device, float temp);
+static void SetDataInvalid(DsDevice_t *device, const uint32_t deviceCount);
+static void SyncShadow(DsBus_t *bus, DsDevice_t *device);
+static void SetRamShadow(DsBus_t *bus, DsDevice_t *device, const uint8_t *cfgData);
+static void CopyShadow(DsBus_t *bus, DsDevice_t *device, bool isMultiMode, RomMode_t romMode);
+static void ForgetShadow(DsBus_t *bus, DsDevice_t *device, bool isMultiMode);
+static void CarryShadow(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount, uint32_t epoch);
+static uint32_t GetRamChangeCount(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount, const uint8_t *cfgData);
+static uint32_t GetRomChangeCount(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount);
+static bool IsRamKnown(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount);
+static bool IsRamEqual(DsBus_t *bus, DsDevice_t *device, const uint8_t *cfgData);
+static bool IsRomEqual(DsBus_t *bus, DsDevice_t *device);
+static INLINE void CountCrcFail(DsBus_t *bus, DsDevice_t *device);
+static bool CheckConvSlow(DsBus_t *bus, DsDevice_t *device, bool *isSlow);
+static INLINE bool IsReservedValid(const uint8_t *rxData);
+static uint32_t TicksToUs(const DsBus_t *bus, uint64_t coreTicks);
+static uint32_t GetDeadline(DsBus_t *bus, uint32_t timeoutMs);
+static uint32_t GetDeadlineUs(DsBus_t *bus, uint32_t timeoutUs);
+static bool IsDeadlinePassed(uint32_t deadline);
+static uint32_t GetConvTimeMs(DsMeasRes_t measRes);
+static DsMeasRes_t GetMaxMeasRes(const DsBus_t *bus, const DsDevice_t *device, const uint32_t deviceCount);
+static bool IsConvTimeOver(DsBus_t *bus);
+static bool IsBusReady(DsBus_t *bus);
 
 /******************************************************************************/
 /*----------------------External Function Definitions-------------------------*/
 /******************************************************************************/
 
+/*
+ *  Set up OW bus (single pin or pin group) and its DS18B20 context
+ */
+extern bool DS18B20_InitBus(DsBus_t *bus, OwConfig_t owConfig)
+{
+    /* Input check */
+    if (bus == NULL)
+    {
+        return false;
+    }
+    
+    bus->sysFreq = OSC_GetSysFreq();
+    bus->tempCorr = 0;
+    bus->isFastRead = false;
+    bus->stats = (DsStats_t){0};
+    bus->quarantineFailCount = 0;
+    bus->probeCycleCount = 0;
+    bus->isParasite = false;
+    bus->isConvPending = false;
+    bus->convDeadline = 0;
+    bus->shadowEpoch = 0;
+    bus->resEpoch = 0;
+    
+    return OW_ConfigBus(&bus->owBus, owConfig);
+}
+
+
+/*
+ *  Get driver and OW counters of bus (times converted to microseconds)
+ */
+extern void DS18B20_GetStats(DsBus_t *bus, DsStats_t *stats)
+{
+    const OwStats_t *owStats = &bus->owBus.stats;
+    
+    *stats = bus->stats;
+    stats->resetCount = owStats->resetCount;
+    stats->presenceFailCount = owStats->presenceFailCount;
+    stats->bitCount = owStats->bitCount;
+    stats->busyUs = TicksToUs(bus, owStats->busyTicks);
+    stats->maxMaskedUs = TicksToUs(bus, owStats->maxMaskedTicks);
+}
+
+
+/*
+ *  Clear counters of bus and of given devices (device NULL - bus only)
+ */
+extern void DS18B20_ResetStats(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount)
+{
+    bus->stats = (DsStats_t){0};
+    OW_ResetStats(&bus->owBus);
+    
+    for (uint32_t idx = 0; (device != NULL) && (idx < deviceCount); idx++)
+    {
+        device[idx].crcFailCount = 0;
+    }
+}
+
+
 /*
  *  Scan and identify all DS18B20 devices on OW bus
  */
-extern uint32_t DS18B20_SearchDeviceId(const uint32_t pinCode, uint64_t *romIdBuff)
+extern uint32_t DS18B20_SearchDeviceId(DsBus_t *bus, DsDevice_t *deviceBuff)
 {
-    return SearchDevice(pinCode, romIdBuff, SEARCH_DEVICE_ID);
+    return SearchDevice(bus, deviceBuff, SEARCH_DEVICE_ID);
 }
 
 
 /*
  *  Scan check alarm flags for all DS18B20 devices on OW bus
  */
-extern uint32_t DS18B20_SearchAlarm(const uint32_t pinCode, uint64_t *romIdBuff)
+extern uint32_t DS18B20_SearchAlarm(DsBus_t *bus, DsDevice_t *deviceBuff)
 {
-    return SearchDevice(pinCode, romIdBuff, SEARCH_DEVICE_ALARM);
+    return SearchDevice(bus, deviceBuff, SEARCH_DEVICE_ALARM);
 }
 
 
 /*
- *  Configure any amount of DS18B20 devices
+ *  Create device handle from known 48-bit serial number (MATCH ROM frame
+ *  is computed once here instead of on every device access)
  */
-extern bool DS18B20_ConfigDevice(DsConfig_t dsConfig, bool isMultiMode)
+extern bool DS18B20_InitDevice(DsDevice_t *device, uint64_t romId)
 {
-    /* Set up OneWire bus */
-    OW_ConfigBus(dsConfig.owConfig);
-    
-    /* Generate CRC LUT once for active use */
-    if (!GenerateCrcLut())
+    /* Inputs check */
+    if ((device == NULL) || (romId == 0) || (romId > 0xFFFFFFFFFFFF))
     {
         return false;
     }
- 
-    /* Modify static structure */
-    statVar.sysFreq = OSC_GetSysFreq();
-    statVar.owPinCode = dsConfig.owConfig.pinCode;
     
-    /* Modify configuration register */
-    return ConfigDevice(dsConfig, isMultiMode);
+    uint64_t romData = (romId << 8) | DS18B20_FAMILY_CODE;
+    uint64_t crcData = EDC_CalculateCrc8Maxim(&romData, 7);
+    
+    device->romId = romId;
+    device->romFrame = romData | (crcData << 56);
+    device->measRes = DS_MEAS_RES_12BIT;    // Power-on default, longest tCONV
+    device->resEpoch = 0;
+    device->crcFailCount = 0;
+    device->isDataValid = false;
+    device->health = (DsHealth_t){0};
+    device->shadow = (DsShadow_t){0};
+    
+    return true;
+}
+
+
+/*
+ *  Configure any amount of DS18B20 devices
+ */
+extern bool DS18B20_ConfigDevice(DsBus_t *bus, DsConfig_t dsConfig, bool isMultiMode)
+{
+    return ConfigDevice(bus, dsConfig, isMultiMode);
 }
 
 
 /*
- *  Saves alarm and resolution settings from RAM to EEPROM
+ *  Saves alarm and resolution settings from RAM to EEPROM (single device
+ *  skipped if its EEPROM is known to hold the RAM settings already)
  */
-extern bool DS18B20_SaveToRom(const uint64_t *romId, bool isMultiMode)
+extern bool DS18B20_SaveToRom(DsBus_t *bus, DsDevice_t *device, bool isMultiMode)
 {
-    return SaveCopyRom(romId, isMultiMode, SAVE_ROM_MODE);
+    return SaveCopyRom(bus, device, isMultiMode, SAVE_ROM_MODE);
 }
 
 
 /*
  *  Reloads alarm and resolution settings from EEPROM to RAM
  */
-extern bool DS18B20_CopyFromRom(const uint64_t *romId, bool isMultiMode)
+extern bool DS18B20_CopyFromRom(DsBus_t *bus, DsDevice_t *device, bool isMultiMode)
+{
+    return SaveCopyRom(bus, device, isMultiMode, COPY_ROM_MODE);
+}
+
+
+/*
+ *  Reload EEPROM settings of all devices to RAM and read them back, so that
+ *  RAM and EEPROM settings of the handles are known (lets DS18B20_ConfigDevice
+ *  and DS18B20_SaveToRom skip writes that would not change anything)
+ */
+extern bool DS18B20_LoadConfig(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount)
 {
-    return SaveCopyRom(romId, isMultiMode, COPY_ROM_MODE);
+    /* Inputs check */
+    if ((device == NULL) || (deviceCount == 0))
+    {
+        return false;
+    }
+    
+    uint8_t rxData[9];
+    bool isAllValid = true;
+    
+    /* Recall EEPROM of all devices at once */
+    bool isOk = SaveCopyRom(bus, NULL, true, COPY_ROM_MODE);
+    
+    /* RAM now equals EEPROM */
+    for (uint32_t idx = 0; (idx < deviceCount) && isOk; idx++)
+    {
+        DsDevice_t *dev = &device[idx];
+        
+        isOk = IsDeviceValid(dev) && ReadDeviceRam(bus, dev, rxData, DS_READ_RAM_REPEAT_COUNT);
+        if (isOk && dev->isDataValid)
+        {
+            CopyShadow(bus, dev, false, SAVE_ROM_MODE);
+        }
+        isAllValid = isAllValid && dev->isDataValid;
+    }
+    
+    return isOk && isAllValid;
 }
 
 
 /*
  *  Set a correction for temperature calculation for all devices
  */
-extern bool DS18B20_SetCorrection(float corr)
+extern bool DS18B20_SetCorrection(DsBus_t *bus, float corr)
 {
     if ((corr < -55.0) || (corr > 125.0))
     {
         return false;
     }
     
-    statVar.tempCorr = corr;
+    bus->tempCorr = corr;
     return true;
 }
 
 
 /*
- *  Check if device is fake (has fixed conversion resolution and time)
+ *  Enable/disable fast temperature read (2 scratch-pad bytes, no CRC)
+ */
+extern void DS18B20_SetFastRead(DsBus_t *bus, bool isFastRead)
+{
+    bus->isFastRead = isFastRead;
+}
+
+
+/*
+ *  Quarantine devices after "failCount" consecutive failed reads (0 - off),
+ *  a quarantined device is skipped by DS18B20_ReadTemp and probed with a
+ *  single read every "probeCycleCount" + 1 calls
+ */
+extern void DS18B20_SetQuarantine(DsBus_t *bus, uint16_t failCount, uint16_t probeCycleCount)
+{
+    bus->quarantineFailCount = failCount;
+    bus->probeCycleCount = probeCycleCount;
+}
+
+
+/*
+ *  Detect parasite powered devices on bus (any device answering READ POWER
+ *  SUPPLY with zero), conversions and EEPROM copies of a parasite bus are
+ *  then timed and powered by strong pull-up (OW_ConfigPullup)
  */
-extern bool DS18B20_IsDeviceFake(const uint64_t *romId)
+extern bool DS18B20_DetectPowerMode(DsBus_t *bus, bool *isParasite)
 {
     /* Presence check */
-    if (!OW_Reset(statVar.owPinCode))
+    if (!IsBusReady(bus) || !OW_Reset(&bus->owBus))
     {
         return false;
     }
     
+    OW_WriteByte(&bus->owBus, SKIP_ROM_CMD);
+    OW_WriteByte(&bus->owBus, READ_POWER_CMD);
+    bus->isParasite = !OW_ReadBit(&bus->owBus);
+    
+    if (isParasite != NULL)
+    {
+        *isParasite = bus->isParasite;
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Check if device is fake (reserved scratch-pad bytes not at their fixed
+ *  values, or fixed conversion resolution and time), false on parasite bus
+ */
+extern bool DS18B20_IsDeviceFake(DsBus_t *bus, DsDevice_t *device)
+{
+    uint8_t rxData[9];
+    bool isSlow;
+    
     /* Input check */
-    if ((*romId == 0) || (romId == NULL))
+    if (!IsDeviceValid(device))
+    {
+        return false;
+    }
+    
+    /* Parasite devices can't signal conversion done */
+    if (bus->isParasite)
     {
         return false;
     }
     
-    /* ROM access code */
-    uint64_t romData = (*romId << 8) | DS18B20_FAMILY_CODE;
-    uint64_t crcData = EDC_CalculateCrc(CRC_POLY_CODE, &romData, 7);
-    romData |= (crcData << 56);
+    /* Reserved bytes check */
+    if (!ReadDeviceRam(bus, device, rxData, DS_READ_RAM_REPEAT_COUNT) || !device->isDataValid)
+    {
+        return false;
+    }
+    if (!IsReservedValid(rxData))
+    {
+        return true;
+    }
     
-    /* Match ROM */
-    OW_WriteByte(statVar.owPinCode, MATCH_ROM_CMD);
-    OW_WriteMultiByte(statVar.owPinCode, &romData, 8);
+    /* Configure to 9-bit resolution (shortest conversion time) */
+    if (!WriteScratchpad(bus, device, 0x00, 0x00, DS_MEAS_RES_9BIT << 5))
+    {
+        return false;
+    }
     
-    /* Configure to 9-bit resolution (95 ms per conversion) */
-    uint8_t measRes = (DS_MEAS_RES_9BIT << 5);
-    uint8_t txData[3] = {0x00, 0x00, measRes};
-    OW_WriteByte(statVar.owPinCode, WRITE_MEM_CMD);
-    OW_WriteMultiByte(statVar.owPinCode, txData, 3);
+    return CheckConvSlow(bus, device, &isSlow) && isSlow;
+}
+
+
+/*
+ *  Check all devices for fakes in one 9-bit conversion window - devices
+ *  whose temperature register is updated within the window are genuine, the
+ *  others (fakes and genuine devices with unchanged temperature) get the
+ *  DS18B20_IsDeviceFake done bit check, reserved bytes are checked for all
+ *  (alarm and resolution settings of every device are restored afterwards,
+ *  fails on parasite bus or if devices can't be checked before a fake
+ *  finishes 12-bit conversion). Costs at standard speed approx. 36 ms per
+ *  device (scratch-pad read, 9-bit write, temperature read and restore),
+ *  19 ms if EEPROM of all devices is known to hold their settings (9-bit
+ *  write and restore by SKIP ROM, "device" must then list the whole bus),
+ *  plus 110 ms per fake and per genuine device with unchanged temperature
+ */
+extern bool DS18B20_FindFakeDevices(DsBus_t *bus, DsDevice_t *device, bool *isFakeBuff, const uint32_t deviceCount)
+{
+    /* Inputs check */
+    if ((device == NULL) || (isFakeBuff == NULL) || (deviceCount == 0) || (deviceCount > DS_MAX_FAKE_CHECK_COUNT))
+    {
+        return false;
+    }
     
-    /* Re-initialize bus */
-    if (!OW_Reset(statVar.owPinCode))
+    /* Parasite devices can't signal conversion done */
+    if (bus->isParasite)
     {
         return false;
     }
     
-    /* Match ROM + convert */
-    OW_WriteByte(statVar.owPinCode, MATCH_ROM_CMD);
-    OW_WriteMultiByte(statVar.owPinCode, &romData, 8);
-    OW_WriteByte(statVar.owPinCode, CONV_TEMP_CMD);
+    uint8_t savedRam[DS_MAX_FAKE_CHECK_COUNT][5];   // Temperature LSB/MSB, TH, TL, config
+    bool isSuspect[DS_MAX_FAKE_CHECK_COUNT];        // Temperature register not updated
+    uint8_t rxData[9];
+    uint32_t configCount = 0;
+    uint32_t epoch = bus->shadowEpoch;
+    bool isRecalled = (GetRomChangeCount(bus, device, deviceCount) == 0);   // Settings restored from EEPROM
+    bool isOk = true;
     
-    /* SYSCLK default value */
-    if (statVar.sysFreq == 0)
+    /* Save scratch-pad, check reserved bytes and set 9-bit resolution (alarm values kept) */
+    while (isOk && (configCount < deviceCount))
+    {
+        DsDevice_t *dev = &device[configCount];
+        
+        isOk = IsDeviceValid(dev) && ReadDeviceRam(bus, dev, rxData, DS_READ_RAM_REPEAT_COUNT) && dev->isDataValid;
+        if (isOk)
+        {
+            for (uint8_t byteIdx = 0; byteIdx < 5; byteIdx++)
+            {
+                savedRam[configCount][byteIdx] = rxData[byteIdx];
+            }
+            isFakeBuff[configCount] = !IsReservedValid(rxData);
+            
+            configCount++;
+            isOk = isRecalled || WriteScratchpad(bus, dev, rxData[2], rxData[3], DS_MEAS_RES_9BIT << 5);
+        }
+    }
+    
+    /* All devices set to 9-bit at once (alarm values recalled afterwards) */
+    if (isOk && isRecalled)
     {
-        statVar.sysFreq = 8000000;
+        isOk = OW_Reset(&bus->owBus);
+        if (isOk)
+        {
+            uint8_t txData[3] = {savedRam[0][2], savedRam[0][3], DS_MEAS_RES_9BIT << 5};
+            
+            OW_WriteByte(&bus->owBus, SKIP_ROM_CMD);
+            OW_WriteByte(&bus->owBus, WRITE_MEM_CMD);
+            OW_WriteMultiByte(&bus->owBus, txData, 3);
+        }
     }
     
-    /* Use Core timer for timeout */
-    uint32_t delay = 95 * (statVar.sysFreq / 1000 / 2);
-    uint32_t timeout = _CP0_GET_COUNT() + delay;
+    /* Convert all devices at once */
+    isOk = isOk && OW_Reset(&bus->owBus);
+    if (isOk)
+    {
+        OW_WriteByte(&bus->owBus, SKIP_ROM_CMD);
+        OW_WriteByte(&bus->owBus, CONV_TEMP_CMD);
+        
+        /* Fakes convert at fixed 12-bit resolution (earliest end - datasheet time less margin) */
+        uint32_t deadline = GetDeadline(bus, GetConvTimeMs(DS_MEAS_RES_9BIT));
+        uint32_t fakeDeadline = GetDeadlineUs(bus, (CONV_TEMP_9BIT_US << DS_MEAS_RES_12BIT) / 100 * (100 - DS_CONV_TEMP_MARGIN_PCT));
+        while (!IsDeadlinePassed(deadline));
+        
+        /* All done - no fakes, single device - done status is its own */
+        bool isAllDone = OW_ReadBit(&bus->owBus);
+        bool isSlow;
+        
+        /* Temperature register updated - genuine (only temperature bytes read,
+           fakes must still be converting when last device is checked) */
+        for (uint32_t idx = 0; (idx < deviceCount) && isOk; idx++)
+        {
+            if (isAllDone || (deviceCount == 1))
+            {
+                isSuspect[idx] = false;
+                isFakeBuff[idx] = !isAllDone || isFakeBuff[idx];
+            }
+            else if (OW_Reset(&bus->owBus))
+            {
+                MatchRom(bus, &device[idx]);
+                OW_WriteByte(&bus->owBus, READ_MEM_CMD);
+                OW_ReadMultiByte(&bus->owBus, rxData, 2);
+                
+                isSuspect[idx] = (rxData[0] == savedRam[idx][0]) && (rxData[1] == savedRam[idx][1]);
+                isOk = !IsDeadlinePassed(fakeDeadline);
+            }
+            else
+            {
+                isOk = false;
+            }
+        }
+        
+        /* Register not updated - conversion of this device alone (a fake is
+           still converting, a genuine device is done within the 9-bit window) */
+        for (uint32_t idx = 0; (idx < deviceCount) && isOk; idx++)
+        {
+            if (isSuspect[idx])
+            {
+                isOk = CheckConvSlow(bus, &device[idx], &isSlow);
+                isFakeBuff[idx] = isSlow || isFakeBuff[idx];
+            }
+        }
+    }
     
-    /* Wait for conversion done */
-    while (timeout > _CP0_GET_COUNT());
+    /* Restore settings of all devices from EEPROM (settings of handles known again) */
+    if (isRecalled)
+    {
+        if (SaveCopyRom(bus, NULL, true, COPY_ROM_MODE))
+        {
+            CarryShadow(bus, device, deviceCount, epoch);
+            for (uint32_t idx = 0; idx < deviceCount; idx++)
+            {
+                CopyShadow(bus, &device[idx], false, COPY_ROM_MODE);
+            }
+        }
+        else
+        {
+            isOk = false;
+        }
+        
+        return isOk;
+    }
     
-    /* Check if not done after 95 ms */
-    if (!OW_ReadBit(statVar.owPinCode))
+    /* Restore settings of all re-configured devices */
+    for (uint32_t idx = 0; idx < configCount; idx++)
     {
-        return true;
+        isOk = WriteScratchpad(bus, &device[idx], savedRam[idx][2], savedRam[idx][3], savedRam[idx][4]) && isOk;
     }
     
-    return false;
+    return isOk;
 }
 
 
 /*
- *  Check if conversion done
+ *  Check if conversion done (parasite bus: conversion time elapsed)
  */
-extern bool DS18B20_IsConvDone(void)
+extern bool DS18B20_IsConvDone(DsBus_t *bus)
 {
+    /* Parasite devices can't signal (read slot would cut their supply) */
+    if (bus->isParasite)
+    {
+        return IsConvTimeOver(bus);
+    }
+    
     /* Conversion in progress check */
-    if (!OW_ReadBit(statVar.owPinCode))
+    if (!OW_ReadBit(&bus->owBus))
     {
         return false;
     }
@@ -210,64 +558,45 @@ extern bool DS18B20_IsConvDone(void)
 
 
 /*
- *  Convert and read temperature with timeout
+ *  Convert and read temperature with timeout (blocking)
  */
-extern bool DS18B20_ConvertReadTemp(const uint64_t *romId, float *dataBuff, const uint8_t deviceCount)
+extern bool DS18B20_ConvertReadTemp(DsBus_t *bus, DsDevice_t *device, float *dataBuff, const uint8_t deviceCount)
 {
-    /* Input check */
-    if (romId == NULL)
-    {
-        return false;
-    }
+    DsConvJob_t convJob;
+    
     /* Start temperature conversion */
-    if (!DS18B20_ConvertTemp(romId, deviceCount))
+    if (!DS18B20_StartConv(bus, &convJob, device, dataBuff, deviceCount))
     {
         return false;
     }
     
-    /* SYSCLK default value */
-    if (statVar.sysFreq == 0)
-    {
-        statVar.sysFreq = 8000000;
-    }
-
-    /* Use Core timer for timeout */
-    uint32_t delay = DS_CONV_TEMP_TIMEOUT_MS * (statVar.sysFreq / 1000 / 2);
-    uint32_t timeout = _CP0_GET_COUNT() + delay;
-    
     /* Wait for conversion done or timeout */
-    while (!DS18B20_IsConvDone() && (timeout > _CP0_GET_COUNT()));
-    
-    /* Timeout check */
-    if (timeout < _CP0_GET_COUNT())
-    {
-        return false;
-    }
+    while (DS18B20_PollConv(&convJob) == DS_CONV_BUSY);
     
     /* Read and convert raw data */
-    return DS18B20_ReadTemp(romId, dataBuff, deviceCount);
+    return (DS18B20_CompleteConv(&convJob) == DS_CONV_DONE);
 }
 
 
 /*
  *  Convert temperature
  */
-extern bool DS18B20_ConvertTemp(const uint64_t *romId, const uint32_t deviceCount)
+extern bool DS18B20_ConvertTemp(DsBus_t *bus, const DsDevice_t *device, const uint32_t deviceCount)
 {
-    /* Inputs check (romId NULL allowed in multi-device mode) */
+    /* Inputs check (device NULL allowed in multi-device mode) */
     if (deviceCount == 0)
     {
         return false;
     }
     
     /* Single device configuration ROM check */
-    if (((*romId == 0) || (romId == NULL)) && (deviceCount == 1))
+    if (!IsDeviceValid(device) && (deviceCount == 1))
     {
         return false;
     }
     
     /* Presence check */
-    if (!OW_Reset(statVar.owPinCode))
+    if (!IsBusReady(bus) || !OW_Reset(&bus->owBus))
     {
         return false;
     }
@@ -275,547 +604,1679 @@ extern bool DS18B20_ConvertTemp(const uint64_t *romId, const uint32_t deviceCoun
     /* Single device mode */
     if (deviceCount == 1)
     {
-        /* Generate ROM access code */
-        uint64_t romData = (*romId << 8) | DS18B20_FAMILY_CODE;
-        uint64_t crcData = EDC_CalculateCrc(CRC_POLY_CODE, &romData, 7);
-        romData |= (crcData << 56);
-        
-        OW_WriteByte(statVar.owPinCode, MATCH_ROM_CMD);
-        OW_WriteMultiByte(statVar.owPinCode, &romData, 8);
+        MatchRom(bus, device);
     }
     /* Multi device mode */
     else
     {
-        OW_WriteByte(statVar.owPinCode, SKIP_ROM_CMD);
+        OW_WriteByte(&bus->owBus, SKIP_ROM_CMD);
     }
     
-    OW_WriteByte(statVar.owPinCode, CONV_TEMP_CMD);
+    /* Parasite supply held by strong pull-up until conversion time elapsed */
+    if (bus->isParasite)
+    {
+        OW_WriteBytePullup(&bus->owBus, CONV_TEMP_CMD);
+        bus->convDeadline = GetDeadlineUs(bus, CONV_TEMP_9BIT_US << GetMaxMeasRes(bus, device, deviceCount));
+        bus->isConvPending = true;
+    }
+    else
+    {
+        OW_WriteByte(&bus->owBus, CONV_TEMP_CMD);
+    }
     
     return true;
 }
 
 
 /*
- *  Read converted temperature data
+ *  Read converted temperature data (device failing all re-reads is skipped
+ *  and flagged in "isDataValid", its data buffer entry is kept), health of
+ *  read devices is updated and quarantined devices are only probed
  */
-extern bool DS18B20_ReadTemp(const uint64_t *romId, float *dataBuff, const uint32_t deviceCount)
+extern bool DS18B20_ReadTemp(DsBus_t *bus, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount)
 {    
     /* Inputs check */
-    if ((romId == NULL) || (dataBuff == NULL) || (deviceCount == 0))
+    if ((device == NULL) || (dataBuff == NULL) || (deviceCount == 0))
     {
         return false;
     }
     
     /* Single device configuration ROM check */
-    if ((*romId == 0) && (deviceCount == 1))
+    if (!IsDeviceValid(device) && (deviceCount == 1))
     {
         return false;
     }
     
-    /* Conversion done check */
-    if (!OW_ReadBit(statVar.owPinCode))
+    SetDataInvalid(device, deviceCount);
+    
+    /* Conversion done check (parasite: conversion time elapsed, pull-up ended) */
+    if (!IsBusReady(bus) || !DS18B20_IsConvDone(bus))
     {
         return false;
     }
 
-    uint64_t romData, crcData;
-    uint8_t rxData[deviceCount][9];
-    uint8_t idxb, idxa = 0;
+    /* Fast read of temperature bytes only */
+    if (bus->isFastRead)
+    {
+        return ReadTempFast(bus, device, dataBuff, deviceCount);
+    }
+
+    uint8_t rxData[9];
+    bool isAllValid = true;
     
-    /* Repeat data read if CRC fails */
-    do
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
     {
-        for (idxb = 0; idxb < deviceCount; idxb++)
+        /* Quarantined device not read until probe cycle */
+        if (IsReadSkipped(bus, &device[idx]))
         {
-            /* Re-initialize bus */
-            if (!OW_Reset(statVar.owPinCode))
-            {
-                return false;
-            }
-            
-            /* Generate ROM access code */
-            romData = (*romId << 8) | DS18B20_FAMILY_CODE;
-            crcData = EDC_CalculateCrc(CRC_POLY_CODE, &romData, 7);
-            romData |= (crcData << 56);
-            romId++;
-
-            /* Match ROM */
-            OW_WriteByte(statVar.owPinCode, MATCH_ROM_CMD);
-            OW_WriteMultiByte(statVar.owPinCode, &romData, 8);
-
-            /* Read scratch-pad */
-            OW_WriteByte(statVar.owPinCode,READ_MEM_CMD);
-            OW_ReadMultiByte(statVar.owPinCode, &rxData[idxb][0], 9);
-                       
-            /* Invalid data receive check */
-            if (EDC_CalculateCrc(CRC_POLY_CODE, &rxData[idxb][0], 9) != 0)
-            {
-                break;
-            }
+            isAllValid = false;
+            continue;
         }
         
-        /* All device's CRC valid */
-        if (idxb == deviceCount)
+        /* Lost presence - remaining devices not read */
+        if (!ReadDeviceRam(bus, &device[idx], rxData, GetRepeatCount(&device[idx])))
         {
-            break;
+            return false;
         }
         
-        idxa++;
-        
-    } while (idxa < DS_READ_RAM_REPEAT_COUNT);
-    
-    /* Broken connection or CRC invalid and neither of devices responded */
-    if ((idxa >= (DS_READ_RAM_REPEAT_COUNT - 1)) && (idxb == 0))
-    {
-        return false;
-    }
-    
-    uint8_t intgr, frctn;
-    float signPart;
-
-    /* Convert raw data to Celsius */
-    for (uint8_t idx = 0; idx < deviceCount; idx++)
-    {
-        intgr = ((rxData[idx][1] & 0x07) << 4) | (rxData[idx][0] >> 4);
-        frctn = rxData[idx][0] & 0x0F;
-        signPart = (rxData[idx][1] & 0x08) ? (-1.0) : (1.0);
+        /* Convert raw data to Celsius (failed device's data kept) */
+        if (device[idx].isDataValid)
+        {
+            dataBuff[idx] = RawToCelsius(bus, rxData);
+        }
+        else
+        {
+            isAllValid = false;
+        }
         
-        *dataBuff = ((float)intgr + (float)frctn / 16) * signPart + statVar.tempCorr;
-        dataBuff++;
+        UpdateHealth(bus, &device[idx], dataBuff[idx]);
     }
     
-    return true;
+    return isAllValid;
 }
 
 
 /*
- *  Read alarm and resolution data from scratch-pad
+ *  Read alarm and resolution data from scratch-pad (per-device re-reads as
+ *  in DS18B20_ReadTemp)
  */
-extern bool DS18B20_ReadRam(const uint64_t *romId, int *dataBuff, const uint32_t deviceCount)
+extern bool DS18B20_ReadRam(DsBus_t *bus, DsDevice_t *device, int *dataBuff, const uint32_t deviceCount)
 { 
     /* Inputs check */
-    if ((dataBuff == NULL) || (deviceCount == 0))
+    if ((device == NULL) || (dataBuff == NULL) || (deviceCount == 0))
     {
         return false;
     }
     
     /* Single device configuration ROM check */
-    if (((*romId == 0) || (romId == NULL)) && (deviceCount == 1))
+    if (!IsDeviceValid(device) && (deviceCount == 1))
     {
         return false;
     }
     
+    SetDataInvalid(device, deviceCount);
+    
     /* Check if bus busy */
-    if (!OW_ReadBit(statVar.owPinCode))
+    if (!IsBusReady(bus) || !OW_ReadBit(&bus->owBus))
     {
         return false;
     }
 
-    uint64_t romData, crcData;
-    uint8_t rxData[deviceCount][9];
-    uint8_t idxb, idxa = 0;
-    
+    uint8_t rxData[9];
     uint8_t loIntgr, hiIntgr;
     int loSign, hiSign;
+    bool isAllValid = true;
     
-    /* Repeat data read if CRC fails */
-    do
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
     {
-        for (idxb = 0; idxb < deviceCount; idxb++)
+        /* Lost presence - remaining devices not read */
+        if (!ReadDeviceRam(bus, &device[idx], rxData, DS_READ_RAM_REPEAT_COUNT))
         {
-            /* Re-initialize bus */
-            if (!OW_Reset(statVar.owPinCode))
-            {
-                return false;
-            }
-            
-            /* Generate ROM access code */
-            romData = (*romId << 8) | DS18B20_FAMILY_CODE;
-            crcData = EDC_CalculateCrc(CRC_POLY_CODE, &romData, 7);
-            romData |= (crcData << 56);
-            romId++;
-
-            /* Match ROM */
-            OW_WriteByte(statVar.owPinCode, MATCH_ROM_CMD);
-            OW_WriteMultiByte(statVar.owPinCode, &romData, 8);
-
-            /* Read scratch-pad */
-            OW_WriteByte(statVar.owPinCode,READ_MEM_CMD);
-            OW_ReadMultiByte(statVar.owPinCode, &rxData[idxb][0], 9);
-            
-            /* Extract sign and integer data (no floating point for alarm) */
-            hiIntgr = rxData[idxb][2] & 0x7E;
-            hiSign = (rxData[idxb][2] & 0x80) ? (-1) : (1);
-            loIntgr = rxData[idxb][3] & 0x7E;
-            loSign = (rxData[idxb][3] & 0x80) ? (-1) : (1);
-            
-            /* Copy HI/LO Alarm and resolution */
-            *(dataBuff + idxb * 3 + 0) = (int)hiIntgr * hiSign;
-            *(dataBuff + idxb * 3 + 1) = (int)loIntgr * loSign;
-            *(dataBuff + idxb * 3 + 2) = (int)(rxData[idxb][4] >> 5);
-                       
-            /* Invalid data receive check */
-            if (EDC_CalculateCrc(CRC_POLY_CODE, &rxData[idxb][0], 9) != 0)
-            {
-                break;
-            }
+            return false;
         }
         
-        /* All device's CRC valid */
-        if (idxb == deviceCount)
+        /* Failed device's data kept */
+        if (!device[idx].isDataValid)
         {
-            break;
+            isAllValid = false;
+            continue;
         }
         
-        idxa++;
+        /* Extract sign and integer data (no floating point for alarm) */
+        hiIntgr = rxData[2] & 0x7E;
+        hiSign = (rxData[2] & 0x80) ? (-1) : (1);
+        loIntgr = rxData[3] & 0x7E;
+        loSign = (rxData[3] & 0x80) ? (-1) : (1);
         
-    } while (idxa < DS_READ_RAM_REPEAT_COUNT);
-    
-    /* Broken connection or CRC invalid and neither of devices responded */
-    if ((idxa >= (DS_READ_RAM_REPEAT_COUNT - 1)) && (idxb == 0))
-    {
-        return false;
+        /* Copy HI/LO Alarm and resolution */
+        *(dataBuff + idx * 3 + 0) = (int)hiIntgr * hiSign;
+        *(dataBuff + idx * 3 + 1) = (int)loIntgr * loSign;
+        *(dataBuff + idx * 3 + 2) = (int)(rxData[4] >> 5);
     }
     
-    return true;
+    return isAllValid;
 }
 
 
-/******************************************************************************/
-/*------------------------Local Function Definitions--------------------------*/
-/******************************************************************************/
-
-
 /*
- *  Generate CRC LUT one time only for active use
+ *  Read converted temperature of one device per bus of configured pin group
+ *  in lockstep (device and data of bus "n" - n-th pin of group from LSB - at
+ *  index n), repeated reads only update buses whose CRC failed
  */
-static bool GenerateCrcLut(void)
+extern bool DS18B20_ReadTempMulti(DsBus_t *bus, DsDevice_t *device, float *dataBuff)
 {
-    static bool isCrcLutGenerated = false;
+    uint8_t busCount = OW_GetBusCount(&bus->owBus);
     
-    if (isCrcLutGenerated == false)
+    /* Inputs check */
+    if ((device == NULL) || (dataBuff == NULL) || (busCount == 0) || (busCount > OW_MAX_BUS_COUNT))
     {
-        isCrcLutGenerated = true;
-        
-        static const CrcConfig_t crcConfig = {
-            .poly = CRC_POLY_CODE,
-            .polySize = CRC_POLY_SIZE,
-            .isInputReflected = true,
-            .isCrcReflected = true
-        };
-        
-        if (!EDC_GenerateCrcLut(crcConfig))
-        {
-            return false;
-        }
+        return false;
     }
     
-    return true;
-}
-
-
-/*
- *  Executes ID or Alarm search
- */
-static uint32_t SearchDevice(const uint32_t pinCode, uint64_t *romIdBuff, SearchMode_t searchMode)
-{
-    uint32_t deviceCount = 0;
-    
-    OwConfig_t owConfig = {
-        .pinCode = pinCode,
-        .speedMode = OW_STANDARD_SPEED
-    };
-    
-    /* Pin code check */
-    if (pinCode == 0)
+    /* Conversion done check (all buses) */
+    if (!IsBusReady(bus) || !OW_ReadBit(&bus->owBus))
     {
-        return deviceCount;
+        return false;
     }
     
-    /* Generate CRC LUT once for active use */
-    if (!GenerateCrcLut())
-    {
-        return deviceCount;
-    }
+    uint8_t txData[busCount][9];
+    uint8_t rxData[busCount][9];
+    uint8_t busIdx, invalidCount, idxa = 0;
     
-    /* Initialize OW bus + presence check */
-    OW_ConfigBus(owConfig);
-    if (!OW_Reset(owConfig.pinCode))
+    /* MATCH ROM frame of each bus */
+    for (busIdx = 0; busIdx < busCount; busIdx++)
     {
-        return deviceCount;
+        if (!IsDeviceValid(&device[busIdx]))
+        {
+            return false;
+        }
+        
+        txData[busIdx][0] = MATCH_ROM_CMD;
+        for (uint8_t byteIdx = 0; byteIdx < 8; byteIdx++)
+        {
+            txData[busIdx][byteIdx + 1] = (device[busIdx].romFrame >> (byteIdx * 8)) & 0xFF;
+        }
     }
     
-    uint64_t romData;
-    uint8_t romBit, romCmpBit, nextBit;
-    int lastZero = -1;                      // -1 identifies the last device
-    int lastDiscrepancy = -1;
-    //int lastFamilyDiscrepancy = -1;
-    bool isLastDevice = false;
-    bool isResetSearch = false;
-    uint8_t repeatSearchCount = 0;
-
-    /* Determine operation type */
-    uint8_t searchCmd = (searchMode == SEARCH_DEVICE_ID) ? SEARCH_ROM_CMD : ALARM_SEARCH_CMD;
-    
-    /* Use Core timer for timeout */
-    statVar.owPinCode = owConfig.pinCode;
-    statVar.sysFreq = OSC_GetSysFreq();
-    uint32_t delay = DS_CONV_TEMP_TIMEOUT_MS * (statVar.sysFreq / 1000 / 2);
-    uint32_t timeout = _CP0_GET_COUNT() + delay;
+    SetDataInvalid(device, busCount);
     
-    /* Loop through all devices */
+    /* Repeat data read if CRC fails (lockstep - all buses are clocked) */
     do
     {
-        lastZero = -1;
-        romData = 0;
+        if (idxa > 0)
+        {
+            bus->stats.retryCount++;
+        }
+        
+        /* Presence on all buses check */
+        if (!OW_Reset(&bus->owBus))
+        {
+            return false;
+        }
         
-        /* Search ROM command */
-        OW_WriteByte(owConfig.pinCode, searchCmd);
+        /* Match ROM + read scratch-pad on all buses */
+        OW_MultiWriteMultiByte(&bus->owBus, txData, 9);
+        OW_WriteByte(&bus->owBus, READ_MEM_CMD);
+        OW_MultiReadMultiByte(&bus->owBus, rxData, 9);
         
-        /* Find ROM */
-        for (uint8_t romBitIdx = 0; romBitIdx < 64; romBitIdx++)
+        /* Validate buses not read yet (valid buses keep their first result) */
+        invalidCount = 0;
+        for (busIdx = 0; busIdx < busCount; busIdx++)
         {
-            /* Read bit and its complement */
-            romBit = OW_ReadBit(owConfig.pinCode);
-            romCmpBit = OW_ReadBit(owConfig.pinCode);
-
-            /* No presence check */
-            if ((romBit == romCmpBit) && (romBit == 1))
+            if (device[busIdx].isDataValid)
             {
-                isResetSearch = true;
-                break;
+                continue;
             }
             
-            /* Case of discrepancy (devices have different current bits) */
-            if ((romBit == romCmpBit) && (romBit == 0))
+            if ((EDC_CalculateCrc8Maxim(&rxData[busIdx][0], 9) != 0) || ((rxData[busIdx][4] & 0x9F) != 0x1F))
             {
-                if (romBitIdx == lastDiscrepancy)
-                {
-                    nextBit = 1;
-                }
-                else if (romBitIdx > lastDiscrepancy)
-                {
-                    nextBit = 0;
-                }
-                /* Next bit is the same from previous ROM number */
-                else
-                {
-                    nextBit = (*(romIdBuff + deviceCount - 1) & (1 << romBitIdx)) > 0;
-                }
-
-                if (nextBit == 0)
-                {
-                    lastZero = romBitIdx;
-                    /*
-                    if (lastZero < 9)
-                    {
-                        lastFamilyDiscrepancy = lastZero;
-                    }
-                    */
-                }
+                CountCrcFail(bus, &device[busIdx]);
+                invalidCount++;
             }
-            /* All devices have the same current bit */
             else
             {
-                nextBit = romBit;
+                device[busIdx].isDataValid = true;
+                dataBuff[busIdx] = RawToCelsius(bus, &rxData[busIdx][0]);
+                SetRamShadow(bus, &device[busIdx], &rxData[busIdx][2]);
             }
-
-            /* Save bit and write it */
-            romData |= ((uint64_t)nextBit << romBitIdx);
-            OW_WriteBit(owConfig.pinCode, nextBit);
         }
         
-        /* Family code check */
-        if ((romData & 0xFF) == DS18B20_FAMILY_CODE)
-        {
-            *(romIdBuff + deviceCount) = (romData >> 8) & 0xFFFFFFFFFFFF;
+        idxa++;
+        
+    } while ((invalidCount > 0) && (idxa < DS_READ_RAM_REPEAT_COUNT));
+    
+    /* CRC invalid after all repeats */
+    return (invalidCount == 0);
+}
 
-            /* Verify ROM CRC */
-            if ((isResetSearch == false) && (EDC_CalculateCrc(CRC_POLY_CODE, &romData, 8) == 0))
-            {
-                lastDiscrepancy = lastZero;
 
-                /* End search */
-                if (lastDiscrepancy == -1)
-                {
-                    isLastDevice = true;
-                }
-                /* Initialize device for next search */
-                else
-                {
-                    if (!OW_Reset(owConfig.pinCode))
-                    {
-                        deviceCount = 0;
-                        return deviceCount;
-                    }
-                }
-                deviceCount++;
-            }
-            /* If no presence or wrong CRC */
-            else
+/*
+ *  Start temperature conversion and return immediately (deadline is set by
+ *  the highest configured resolution of given devices)
+ */
+extern bool DS18B20_StartConv(DsBus_t *bus, DsConvJob_t *job, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount)
+{
+    /* Inputs check */
+    if ((bus == NULL) || (job == NULL) || (device == NULL) || (dataBuff == NULL))
+    {
+        return false;
+    }
+    
+    job->bus = bus;
+    job->device = device;
+    job->dataBuff = dataBuff;
+    job->deviceCount = deviceCount;
+    
+    /* Start temperature conversion */
+    if (!DS18B20_ConvertTemp(bus, device, deviceCount))
+    {
+        job->state = DS_CONV_ERROR;
+        return false;
+    }
+    
+    /* Parasite: datasheet tCONV (pull-up time), otherwise timeout with margin */
+    if (bus->isParasite)
+    {
+        job->deadline = bus->convDeadline;
+    }
+    else
+    {
+        job->deadline = GetDeadline(bus, GetConvTimeMs(GetMaxMeasRes(bus, device, deviceCount)));
+    }
+    job->state = DS_CONV_BUSY;
+    
+    return true;
+}
+
+
+/*
+ *  Check conversion progress (single read slot, call from loop or tick) -
+ *  devices reporting done early complete before the deadline
+ */
+extern DsConvState_t DS18B20_PollConv(DsConvJob_t *job)
+{
+    /* Input check */
+    if (job == NULL)
+    {
+        return DS_CONV_ERROR;
+    }
+    
+    if (job->state == DS_CONV_BUSY)
+    {
+        /* Parasite: done when conversion time elapsed (no bus access) */
+        if (job->bus->isParasite)
+        {
+            if (IsBusReady(job->bus))
             {
-                lastDiscrepancy = -1;
-                //lastFamilyDiscrepancy = -1;
-                isLastDevice = false;
-                isResetSearch = false;
-                deviceCount = 0;
-                repeatSearchCount++;
+                job->state = DS_CONV_READY;
             }
         }
-    } while ((isLastDevice == false) &&
-             (repeatSearchCount < DS_SEARCH_DEVICE_REPEAT_COUNT) &&
-             (timeout > _CP0_GET_COUNT()));
+        else if (DS18B20_IsConvDone(job->bus))
+        {
+            job->state = DS_CONV_READY;
+        }
+        else if (IsDeadlinePassed(job->deadline))
+        {
+            job->state = DS_CONV_TIMEOUT;
+        }
+    }
+    
+    return job->state;
+}
+
+
+/*
+ *  Read scratch-pads of finished conversion into job's data buffer
+ */
+extern DsConvState_t DS18B20_CompleteConv(DsConvJob_t *job)
+{
+    /* Progress update */
+    if (DS18B20_PollConv(job) != DS_CONV_READY)
+    {
+        return (job != NULL) ? job->state : DS_CONV_ERROR;
+    }
     
-    /* Scan not successful */
-    if (isLastDevice != true)
+    /* Read and convert raw data */
+    if (DS18B20_ReadTemp(job->bus, job->device, job->dataBuff, job->deviceCount))
     {
-        deviceCount = 0;
+        job->state = DS_CONV_DONE;
     }
-
-    return deviceCount;
+    else
+    {
+        job->state = DS_CONV_ERROR;
+    }
+    
+    return job->state;
 }
 
+
 /*
- *  Starts temperature conversion of (single/multiple) DS18B20 device
+ *  Start ROM search (ID or alarm) and return after the first reset, devices
+ *  are found by DS18B20_PollSearch (bus owned by job until done)
  */
-static bool ConfigDevice(DsConfig_t dsConfig, bool isMultiMode)
+extern bool DS18B20_StartSearch(DsBus_t *bus, DsSearchJob_t *job, DsDevice_t *deviceBuff, bool isAlarm)
 {
-    /* Single device configuration ROM check */
-    if ((dsConfig.deviceId == 0) && (isMultiMode == false))
+    /* Inputs check */
+    if ((job == NULL) || (deviceBuff == NULL))
     {
         return false;
     }
     
-    int hiAlarm, loAlarm;
-    uint8_t rawHiAlarm, rawLoAlarm;
+    return StartSearch(bus, job, deviceBuff, isAlarm ? SEARCH_DEVICE_ALARM : SEARCH_DEVICE_ID);
+}
+
+
+/*
+ *  Walk one branch of search tree (one device found per call, approx. 13 ms
+ *  at standard speed), "deviceCount" of job is final when DONE
+ */
+extern DsConvState_t DS18B20_PollSearch(DsSearchJob_t *job)
+{
+    /* Input check */
+    if (job == NULL)
+    {
+        return DS_CONV_ERROR;
+    }
     
-    /* Configure alarm values */
-    if (hiAlarm != loAlarm)
+    if (job->state != DS_CONV_BUSY)
     {
-        hiAlarm = dsConfig.highAlarm + (int)statVar.tempCorr;
-        loAlarm = dsConfig.lowAlarm + (int)statVar.tempCorr;    
-        hiAlarm = (hiAlarm > MAX_TEMP) ? MAX_TEMP : hiAlarm;
-        loAlarm = (loAlarm < MIN_TEMP) ? MIN_TEMP : loAlarm;
-
-        /* Add negative sign if negative */
-        if (hiAlarm < 0)
-        {
-            rawHiAlarm = 0x80 | (uint8_t)(255 - (uint8_t)hiAlarm + 1);
-        }
-        else
-        {
-            rawHiAlarm = hiAlarm;
-        }
+        return job->state;
+    }
+    
+    DsBus_t *bus = job->bus;
+    uint64_t romData;
+    int lastZero;
+    
+    /* Each pass timed on its own (time between polls not counted) */
+    job->deadline = GetDeadline(bus, DS_SEARCH_ID_TIMEOUT_MS);
+    
+    /* Verify ROM CRC */
+    if (SearchRom(job, &romData, &lastZero))
+    {
+        job->lastDiscrepancy = lastZero;
+        job->lastRomData = romData;
         
-        /* Add negative sign if negative */
-        if (loAlarm < 0)
+        /* Family code check (other device types are skipped) */
+        if ((romData & 0xFF) == DS18B20_FAMILY_CODE)
         {
-            rawLoAlarm = 0x80 | (uint8_t)(255 - (uint8_t)loAlarm + 1);
+            DsDevice_t *dev = &job->deviceBuff[job->deviceCount++];
+            
+            dev->romId = (romData >> 8) & 0xFFFFFFFFFFFF;
+            dev->romFrame = romData;
+            dev->measRes = DS_MEAS_RES_12BIT;
+            dev->resEpoch = 0;
+            dev->crcFailCount = 0;
+            dev->isDataValid = false;
+            dev->health = (DsHealth_t){0};
+            dev->shadow = (DsShadow_t){0};
         }
-        else
+        
+        /* End search */
+        if (job->lastDiscrepancy == -1)
         {
-            rawLoAlarm = loAlarm;
+            FinishSearch(job, DS_CONV_DONE);
+            return job->state;
         }
     }
-    /* Alarm flag never triggered if alarm not configured */
+    /* If no presence or wrong CRC restart search from the beginning */
     else
     {
-        rawHiAlarm = MAX_TEMP;
-        rawLoAlarm = 0x80 | 55;
+        job->lastDiscrepancy = -1;
+        job->lastRomData = 0;
+        job->deviceCount = 0;
+        job->repeatCount++;
+        bus->stats.searchRestartCount++;
     }
     
-    /* Initialize bus */
-    if (!OW_Reset(statVar.owPinCode))
+    /* Initialize devices for next pass */
+    if (!OW_Reset(&bus->owBus) || (job->repeatCount >= DS_SEARCH_DEVICE_REPEAT_COUNT))
+    {
+        FinishSearch(job, DS_CONV_ERROR);
+    }
+    else if (IsDeadlinePassed(job->deadline))
+    {
+        FinishSearch(job, DS_CONV_TIMEOUT);
+    }
+    
+    return job->state;
+}
+
+
+/*
+ *  Write alarm and resolution settings at once and start saving them to
+ *  EEPROM if "isSaved" (transfers finished by DS18B20_PollRom)
+ */
+extern bool DS18B20_StartConfig(DsBus_t *bus, DsRomJob_t *job, DsConfig_t dsConfig, bool isMultiMode)
+{
+    /* Inputs check */
+    if ((bus == NULL) || (job == NULL))
     {
         return false;
     }
     
-    uint8_t txData[3] = {rawHiAlarm, rawLoAlarm, (dsConfig.measRes << 5)};
+    bool isSaved = dsConfig.isSaved;
     
-    /* Configure RAM for multiple devices */
-    if (isMultiMode)
+    InitRomJob(bus, job, SAVE_ROM_MODE);
+    dsConfig.isSaved = false;
+    
+    if (!ConfigDevice(bus, dsConfig, isMultiMode))
     {
-        OW_WriteByte(statVar.owPinCode, SKIP_ROM_CMD);
-        OW_WriteByte(statVar.owPinCode, WRITE_MEM_CMD);
-        OW_WriteMultiByte(statVar.owPinCode, txData, 3);
+        job->state = DS_CONV_ERROR;
     }
-    /* Configure RAM for a single device */
-    else
+    else if (isSaved)
     {
-        uint64_t romData = (dsConfig.deviceId << 8) | DS18B20_FAMILY_CODE;
-        uint64_t crcData = EDC_CalculateCrc(CRC_POLY_CODE, &romData, 7);
-        romData |= (crcData << 56);
-    
-        OW_WriteByte(statVar.owPinCode, WRITE_MEM_CMD);
-        OW_WriteMultiByte(statVar.owPinCode, txData, 3);
+        StartSaveConfig(bus, job, dsConfig, isMultiMode);
     }
     
-    return true;
+    return (job->state != DS_CONV_ERROR);
 }
 
 
 /*
- *  Execute Copy Scratch-pad (aka. Save ROM) or Recall EEPROM (aka. Copy ROM)
+ *  Start copy of RAM settings to EEPROM and return immediately (single
+ *  device skipped if its EEPROM is known to hold the RAM settings already)
  */
-static bool SaveCopyRom(const uint64_t *romId, bool isMultiMode, RomMode_t romMode)
+extern bool DS18B20_StartSave(DsBus_t *bus, DsRomJob_t *job, DsDevice_t *device, bool isMultiMode)
 {
-    /* Single device configuration ROM check */
-    if ((*romId == 0) && (isMultiMode = false))
+    /* Inputs check */
+    if ((bus == NULL) || (job == NULL))
     {
         return false;
     }
+    
+    StartRomJob(bus, job, device, isMultiMode, SAVE_ROM_MODE);
+    
+    return (job->state != DS_CONV_ERROR);
+}
 
-    /* Initialize bus */
-    if (!OW_Reset(statVar.owPinCode))
+
+/*
+ *  Start reload of EEPROM settings to RAM and return immediately
+ */
+extern bool DS18B20_StartRecall(DsBus_t *bus, DsRomJob_t *job, DsDevice_t *device, bool isMultiMode)
+{
+    /* Inputs check */
+    if ((bus == NULL) || (job == NULL))
     {
         return false;
     }
     
-    /* Skip ROM for multiple devices */
-    if (isMultiMode == true)
+    StartRomJob(bus, job, device, isMultiMode, COPY_ROM_MODE);
+    
+    return (job->state != DS_CONV_ERROR);
+}
+
+
+/*
+ *  Check EEPROM transfer progress (single read slot, parasite save: no bus
+ *  access) and start next transfer of a configuration save
+ */
+extern DsConvState_t DS18B20_PollRom(DsRomJob_t *job)
+{
+    /* Input check */
+    if (job == NULL)
     {
-        OW_WriteByte(statVar.owPinCode, SKIP_ROM_CMD);
+        return DS_CONV_ERROR;
     }
-    /* Access ROM for single device */
-    else
+    
+    if (job->state == DS_CONV_BUSY)
     {
-        uint64_t romData = (*romId << 8) | DS18B20_FAMILY_CODE;
-        uint64_t crcData = EDC_CalculateCrc(CRC_POLY_CODE, &romData, 7);
-        romData |= (crcData << 56);
+        PollTransfer(job);
+        NextTransfer(job);
+    }
+    
+    return job->state;
+}
+
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
 
-        OW_WriteByte(statVar.owPinCode, MATCH_ROM_CMD);
-        OW_WriteMultiByte(statVar.owPinCode, &romData, 8);
+/*
+ *  Executes ID or Alarm search
+ */
+static uint32_t SearchDevice(DsBus_t *bus, DsDevice_t *deviceBuff, SearchMode_t searchMode)
+{
+    DsSearchJob_t job;
+    
+    if (!StartSearch(bus, &job, deviceBuff, searchMode))
+    {
+        return 0;
     }
     
-    /* Save RAM settings to EEPROM */
-    if (romMode == SAVE_ROM_MODE)
+    while (DS18B20_PollSearch(&job) == DS_CONV_BUSY);
+    
+    return job.deviceCount;
+}
+
+
+/*
+ *  Set up search job and initialize devices for the first pass
+ */
+static bool StartSearch(DsBus_t *bus, DsSearchJob_t *job, DsDevice_t *deviceBuff, SearchMode_t searchMode)
+{
+    job->bus = bus;
+    job->deviceBuff = deviceBuff;
+    job->deviceCount = 0;
+    job->lastRomData = 0;
+    job->lastDiscrepancy = -1;
+    job->repeatCount = 0;
+    job->state = DS_CONV_ERROR;
+    
+    /* Bus check */
+    if ((bus == NULL) || (bus->owBus.pinCode == 0) || !IsBusReady(bus))
     {
-        OW_WriteByte(statVar.owPinCode, COPY_MEM_CMD);
+        return false;
     }
-    /* Load EEPROM settings to RAM */
-    else
+    
+    /* Determine operation type */
+    job->searchCmd = (searchMode == SEARCH_DEVICE_ID) ? SEARCH_ROM_CMD : ALARM_SEARCH_CMD;
+    
+    /* Search at standard speed (bus speed restored when done) */
+    job->speedMode = bus->owBus.speedMode;
+    OW_ConfigSpeedMode(&bus->owBus, OW_STANDARD_SPEED);
+    
+    /* Presence check */
+    if (!OW_Reset(&bus->owBus))
     {
-        OW_WriteByte(statVar.owPinCode, RECALL_EEPROM_CMD);
+        OW_ConfigSpeedMode(&bus->owBus, job->speedMode);
+        return false;
     }
     
-    /* SYSCLK default value */
-    if (statVar.sysFreq == 0)
+    job->state = DS_CONV_BUSY;
+    
+    return true;
+}
+
+
+/*
+ *  Walk one branch of ROM search tree of initialized bus, false on lost
+ *  presence or ROM CRC failure
+ */
+static bool SearchRom(DsSearchJob_t *job, uint64_t *romData, int *lastZero)
+{
+    OwBus_t *owBus = &job->bus->owBus;
+    uint8_t romBit, romCmpBit, nextBit;
+    
+    *lastZero = -1;
+    *romData = 0;
+    
+    /* Search ROM command */
+    OW_WriteByte(owBus, job->searchCmd);
+    
+    /* Find ROM */
+    for (uint8_t romBitIdx = 0; romBitIdx < 64; romBitIdx++)
     {
-        statVar.sysFreq = 8000000;
+        /* Read bit and its complement */
+        romBit = OW_ReadBit(owBus);
+        romCmpBit = OW_ReadBit(owBus);
+        
+        /* No presence check */
+        if ((romBit == romCmpBit) && (romBit == 1))
+        {
+            return false;
+        }
+        
+        /* Case of discrepancy (devices have different current bits) */
+        if ((romBit == romCmpBit) && (romBit == 0))
+        {
+            if (romBitIdx == job->lastDiscrepancy)
+            {
+                nextBit = 1;
+            }
+            else if (romBitIdx > job->lastDiscrepancy)
+            {
+                nextBit = 0;
+            }
+            /* Next bit is the same from previous ROM number */
+            else
+            {
+                nextBit = (job->lastRomData >> romBitIdx) & 0x01;
+            }
+            
+            if (nextBit == 0)
+            {
+                *lastZero = romBitIdx;
+            }
+        }
+        /* All devices have the same current bit */
+        else
+        {
+            nextBit = romBit;
+        }
+        
+        /* Save bit and write it */
+        *romData |= ((uint64_t)nextBit << romBitIdx);
+        OW_WriteBit(owBus, nextBit);
     }
     
-    /* Use Core timer for timeout */
-    uint32_t delay = DS_SAVE_COPY_ROM_TIMEOUT_MS * (statVar.sysFreq / 1000 / 2);
-    uint32_t timeout = _CP0_GET_COUNT() + delay;
+    return (EDC_CalculateCrc8Maxim(romData, 8) == 0);
+}
 
-    /* Wait for conversion done */
-    while (!OW_ReadBit(statVar.owPinCode) && (timeout > _CP0_GET_COUNT()));
 
-    /* Timeout check */
-    if (timeout < _CP0_GET_COUNT())
+/*
+ *  End search (devices found only count if done) and restore bus speed
+ */
+static void FinishSearch(DsSearchJob_t *job, DsConvState_t state)
+{
+    if (state != DS_CONV_DONE)
+    {
+        job->deviceCount = 0;
+    }
+    
+    OW_ConfigSpeedMode(&job->bus->owBus, job->speedMode);
+    job->state = state;
+}
+
+/*
+ *  Starts temperature conversion of (single/multiple) DS18B20 device
+ */
+static bool ConfigDevice(DsBus_t *bus, DsConfig_t dsConfig, bool isMultiMode)
+{
+    /* Single device configuration ROM check */
+    if (!IsDeviceValid(dsConfig.device) && (isMultiMode == false))
+    {
+        return false;
+    }
+    
+    /* Parasite conversion or EEPROM copy check */
+    if (!IsBusReady(bus))
+    {
+        return false;
+    }
+    
+    int hiAlarm, loAlarm;
+    uint8_t rawHiAlarm, rawLoAlarm;
+    
+    /* Configure alarm values */
+    if (dsConfig.highAlarm != dsConfig.lowAlarm)
+    {
+        hiAlarm = dsConfig.highAlarm + (int)bus->tempCorr;
+        loAlarm = dsConfig.lowAlarm + (int)bus->tempCorr;    
+        hiAlarm = (hiAlarm > MAX_TEMP) ? MAX_TEMP : hiAlarm;
+        loAlarm = (loAlarm < MIN_TEMP) ? MIN_TEMP : loAlarm;
+
+        /* Add negative sign if negative */
+        if (hiAlarm < 0)
+        {
+            rawHiAlarm = 0x80 | (uint8_t)(255 - (uint8_t)hiAlarm + 1);
+        }
+        else
+        {
+            rawHiAlarm = hiAlarm;
+        }
+        
+        /* Add negative sign if negative */
+        if (loAlarm < 0)
+        {
+            rawLoAlarm = 0x80 | (uint8_t)(255 - (uint8_t)loAlarm + 1);
+        }
+        else
+        {
+            rawLoAlarm = loAlarm;
+        }
+    }
+    /* Alarm flag never triggered if alarm not configured */
+    else
+    {
+        rawHiAlarm = MAX_TEMP;
+        rawLoAlarm = 0x80 | 55;
+    }
+    
+    uint8_t txData[3] = {rawHiAlarm, rawLoAlarm, (dsConfig.measRes << 5)};
+    
+    /* Configure RAM of changed devices only (RAM of all handles known) */
+    if (isMultiMode && (GetRamChangeCount(bus, dsConfig.device, dsConfig.deviceCount, txData) < dsConfig.deviceCount))
+    {
+        for (uint32_t idx = 0; idx < dsConfig.deviceCount; idx++)
+        {
+            DsDevice_t *dev = &dsConfig.device[idx];
+            
+            if (IsRamEqual(bus, dev, txData))
+            {
+                bus->stats.writeSkipCount++;
+            }
+            else if (!WriteScratchpad(bus, dev, txData[0], txData[1], txData[2]))
+            {
+                return false;
+            }
+        }
+    }
+    /* Configure RAM for multiple devices */
+    else if (isMultiMode)
+    {
+        uint32_t epoch = bus->shadowEpoch;
+        
+        if (!OW_Reset(&bus->owBus))
+        {
+            return false;
+        }
+        
+        OW_WriteByte(&bus->owBus, SKIP_ROM_CMD);
+        OW_WriteByte(&bus->owBus, WRITE_MEM_CMD);
+        OW_WriteMultiByte(&bus->owBus, txData, 3);
+        
+        /* Devices without handle written too */
+        bus->shadowEpoch++;
+        bus->resEpoch++;
+        CarryShadow(bus, dsConfig.device, dsConfig.deviceCount, epoch);
+        for (uint32_t idx = 0; (dsConfig.device != NULL) && (idx < dsConfig.deviceCount); idx++)
+        {
+            SetRamShadow(bus, &dsConfig.device[idx], txData);
+        }
+    }
+    /* Configure RAM for a single device */
+    else if (IsRamEqual(bus, dsConfig.device, txData))
+    {
+        bus->stats.writeSkipCount++;
+    }
+    else if (!WriteScratchpad(bus, dsConfig.device, txData[0], txData[1], txData[2]))
+    {
+        return false;
+    }
+    
+    /* Save settings where EEPROM doesn't hold them yet */
+    if (dsConfig.isSaved)
+    {
+        return SaveConfig(bus, dsConfig, isMultiMode);
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Save configuration written by ConfigDevice (blocking)
+ */
+static bool SaveConfig(DsBus_t *bus, DsConfig_t dsConfig, bool isMultiMode)
+{
+    DsRomJob_t job;
+    
+    StartSaveConfig(bus, &job, dsConfig, isMultiMode);
+    
+    return WaitRomJob(&job);
+}
+
+
+/*
+ *  Copy RAM settings to EEPROM of changed devices one by one (RAM and EEPROM
+ *  of all handles known), of all devices at once otherwise
+ */
+static void StartSaveConfig(DsBus_t *bus, DsRomJob_t *job, DsConfig_t dsConfig, bool isMultiMode)
+{
+    InitRomJob(bus, job, SAVE_ROM_MODE);
+    
+    if (!isMultiMode)
+    {
+        StartTransfer(job, dsConfig.device, false);
+        return;
+    }
+    
+    job->handle = dsConfig.device;
+    job->handleCount = dsConfig.deviceCount;
+    
+    /* Changed handles started by NextTransfer */
+    if (GetRomChangeCount(bus, dsConfig.device, dsConfig.deviceCount) < dsConfig.deviceCount)
+    {
+        job->state = DS_CONV_DONE;
+    }
+    else
+    {
+        job->epoch = bus->shadowEpoch;
+        StartTransfer(job, NULL, true);
+    }
+    
+    NextTransfer(job);
+}
+
+
+/*
+ *  Execute Copy Scratch-pad (aka. Save ROM) or Recall EEPROM (aka. Copy ROM)
+ */
+static bool SaveCopyRom(DsBus_t *bus, DsDevice_t *device, bool isMultiMode, RomMode_t romMode)
+{
+    DsRomJob_t job;
+    
+    StartRomJob(bus, &job, device, isMultiMode, romMode);
+    
+    return WaitRomJob(&job);
+}
+
+
+/*
+ *  Start single EEPROM transfer job
+ */
+static void StartRomJob(DsBus_t *bus, DsRomJob_t *job, DsDevice_t *device, bool isMultiMode, RomMode_t romMode)
+{
+    InitRomJob(bus, job, romMode);
+    StartTransfer(job, device, isMultiMode);
+}
+
+
+/*
+ *  Set up EEPROM job without transfers (done)
+ */
+static void InitRomJob(DsBus_t *bus, DsRomJob_t *job, RomMode_t romMode)
+{
+    job->bus = bus;
+    job->device = NULL;
+    job->handle = NULL;
+    job->handleCount = 0;
+    job->handleIdx = 0;
+    job->epoch = bus->shadowEpoch;
+    job->isMultiMode = false;
+    job->isRecall = (romMode == COPY_ROM_MODE);
+    job->state = DS_CONV_DONE;
+}
+
+
+/*
+ *  Address device(s) and send copy or recall command (done at once if the
+ *  copy would not change EEPROM)
+ */
+static void StartTransfer(DsRomJob_t *job, DsDevice_t *device, bool isMultiMode)
+{
+    DsBus_t *bus = job->bus;
+    
+    job->device = device;
+    job->isMultiMode = isMultiMode;
+    
+    /* Single device configuration ROM check */
+    if (!IsDeviceValid(device) && (isMultiMode == false))
+    {
+        job->state = DS_CONV_ERROR;
+        return;
+    }
+    
+    /* EEPROM already holds RAM settings (saves write time and EEPROM wear) */
+    if (!job->isRecall && !isMultiMode && IsRomEqual(bus, device))
+    {
+        bus->stats.writeSkipCount++;
+        job->state = DS_CONV_DONE;
+        return;
+    }
+    
+    /* Initialize bus */
+    if (!IsBusReady(bus) || !OW_Reset(&bus->owBus))
+    {
+        job->state = DS_CONV_ERROR;
+        return;
+    }
+    
+    /* Skip ROM for multiple devices */
+    if (isMultiMode == true)
+    {
+        OW_WriteByte(&bus->owBus, SKIP_ROM_CMD);
+    }
+    /* Access ROM for single device */
+    else
+    {
+        MatchRom(bus, device);
+    }
+    
+    /* Save RAM settings to EEPROM (parasite: powered for datasheet tWR) */
+    if (!job->isRecall && bus->isParasite)
+    {
+        OW_WriteBytePullup(&bus->owBus, COPY_MEM_CMD);
+        job->deadline = GetDeadlineUs(bus, COPY_MEM_US);
+        bus->convDeadline = job->deadline;
+        bus->isConvPending = true;
+    }
+    else
+    {
+        OW_WriteByte(&bus->owBus, job->isRecall ? RECALL_EEPROM_CMD : COPY_MEM_CMD);
+        job->deadline = GetDeadline(bus, DS_SAVE_COPY_ROM_TIMEOUT_MS);
+    }
+    
+    job->state = DS_CONV_BUSY;
+}
+
+
+/*
+ *  Check if EEPROM transfer done or timed out (settings in doubt)
+ */
+static void PollTransfer(DsRomJob_t *job)
+{
+    DsBus_t *bus = job->bus;
+    
+    /* Parasite: copied when datasheet tWR elapsed (no bus access) */
+    if (!job->isRecall && bus->isParasite)
+    {
+        if (!IsBusReady(bus))
+        {
+            return;
+        }
+    }
+    /* Device holds bus low until transfer done */
+    else if (!OW_ReadBit(&bus->owBus))
+    {
+        if (IsDeadlinePassed(job->deadline))
+        {
+            ForgetShadow(bus, job->device, job->isMultiMode);
+            job->state = DS_CONV_TIMEOUT;
+        }
+        
+        return;
+    }
+    
+    CopyShadow(bus, job->device, job->isMultiMode, job->isRecall ? COPY_ROM_MODE : SAVE_ROM_MODE);
+    job->state = DS_CONV_DONE;
+}
+
+
+/*
+ *  Continue configuration save after a finished transfer - next changed
+ *  handle (unchanged ones done at once), or shadows of handles carried
+ *  over a SKIP ROM save
+ */
+static void NextTransfer(DsRomJob_t *job)
+{
+    if (job->state != DS_CONV_DONE)
+    {
+        return;
+    }
+    
+    /* EEPROM of handles now holds their RAM settings */
+    if (job->isMultiMode)
+    {
+        CarryShadow(job->bus, job->handle, job->handleCount, job->epoch);
+        for (uint32_t idx = 0; (job->handle != NULL) && (idx < job->handleCount); idx++)
+        {
+            CopyShadow(job->bus, &job->handle[idx], false, SAVE_ROM_MODE);
+        }
+        
+        job->handleCount = 0;
+        return;
+    }
+    
+    while ((job->state == DS_CONV_DONE) && (job->handleIdx < job->handleCount))
+    {
+        StartTransfer(job, &job->handle[job->handleIdx++], false);
+    }
+}
+
+
+/*
+ *  Poll EEPROM job until done (blocking)
+ */
+static bool WaitRomJob(DsRomJob_t *job)
+{
+    while (DS18B20_PollRom(job) == DS_CONV_BUSY);
+    
+    return (job->state == DS_CONV_DONE);
+}
+
+
+/*
+ *  Write alarm values and configuration register of a single device
+ */
+static bool WriteScratchpad(DsBus_t *bus, DsDevice_t *device, uint8_t hiAlarm, uint8_t loAlarm, uint8_t config)
+{
+    uint8_t txData[3] = {hiAlarm, loAlarm, config};
+    
+    if (!OW_Reset(&bus->owBus))
+    {
+        return false;
+    }
+    
+    MatchRom(bus, device);
+    OW_WriteByte(&bus->owBus, WRITE_MEM_CMD);
+    OW_WriteMultiByte(&bus->owBus, txData, 3);
+    SetRamShadow(bus, device, txData);
+    
+    return true;
+}
+
+
+/*
+ *  Read scratch-pad of addressed device and validate it while receiving
+ */
+static bool ReadScratchpad(DsBus_t *bus, uint8_t *rxData)
+{
+    ScratchpadRead_t spRead = {.crcVal = 0x00, .byteIdx = 0};
+    
+    OW_WriteByte(&bus->owBus, READ_MEM_CMD);
+    if (!OW_ReadMultiByteHook(&bus->owBus, rxData, 9, ScratchpadByteHook, &spRead))
+    {
+        return false;
+    }
+    
+    return (spRead.crcVal == 0);
+}
+
+
+/*
+ *  Update CRC with received scratch-pad byte and abort on a configuration
+ *  register that can't be valid (bits 0-4 always read 1, bit 7 reads 0)
+ */
+static bool ScratchpadByteHook(void *context, uint8_t dataByte)
+{
+    ScratchpadRead_t *spRead = context;
+    
+    spRead->crcVal = EDC_UpdateCrc8Maxim(spRead->crcVal, dataByte);
+    
+    if ((spRead->byteIdx++ == 4) && ((dataByte & 0x9F) != 0x1F))
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Read scratch-pad of a single device up to "repeatCount" times, re-reading
+ *  only this device on CRC failure (result stored in device's "isDataValid"),
+ *  false on lost presence
+ */
+static bool ReadDeviceRam(DsBus_t *bus, DsDevice_t *device, uint8_t *rxData, uint8_t repeatCount)
+{
+    device->isDataValid = false;
+    
+    for (uint8_t repeatIdx = 0; (repeatIdx < repeatCount) && !device->isDataValid; repeatIdx++)
+    {
+        if (repeatIdx > 0)
+        {
+            bus->stats.retryCount++;
+        }
+        
+        /* Re-initialize bus */
+        if (!OW_Reset(&bus->owBus))
+        {
+            return false;
+        }
+        
+        /* Match ROM + read scratch-pad + invalid data receive check */
+        MatchRom(bus, device);
+        device->isDataValid = ReadScratchpad(bus, rxData);
+        if (!device->isDataValid)
+        {
+            CountCrcFail(bus, device);
+        }
+        else
+        {
+            SetRamShadow(bus, device, &rxData[2]);
+        }
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Read temperature bytes only and terminate scratch-pad read with a reset
+ *  (implausible values are re-read, all-ones and power-on values are only
+ *  accepted if confirmed by a CRC-checked read of the whole scratch-pad)
+ */
+static bool ReadTempFast(DsBus_t *bus, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount)
+{
+    uint16_t rawTemp;
+    uint8_t rxData[2], ramData[9];
+    uint8_t repeatCount;
+    bool isValid, isAllValid = true;
+    
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
+    {
+        /* Quarantined device not read until probe cycle */
+        if (IsReadSkipped(bus, &device[idx]))
+        {
+            isAllValid = false;
+            continue;
+        }
+        
+        isValid = false;
+        repeatCount = GetRepeatCount(&device[idx]);
+        
+        for (uint8_t repeatIdx = 0; (repeatIdx < repeatCount) && !isValid; repeatIdx++)
+        {
+            if (repeatIdx > 0)
+            {
+                bus->stats.retryCount++;
+            }
+            
+            /* Re-initialize bus (lost presence - remaining devices not read) */
+            if (!OW_Reset(&bus->owBus))
+            {
+                return false;
+            }
+            
+            /* Match ROM + read temperature LSB and MSB */
+            MatchRom(bus, &device[idx]);
+            OW_WriteByte(&bus->owBus, READ_MEM_CMD);
+            OW_ReadMultiByte(&bus->owBus, rxData, 2);
+            
+            rawTemp = ((uint16_t)rxData[1] << 8) | rxData[0];
+            
+            if (!IsTempPlausible(rxData))
+            {
+                CountCrcFail(bus, &device[idx]);
+            }
+            /* Silent device (bus reads all ones) or 85 degC after power-on: confirm
+             * with full read, also done if only a single read is allowed */
+            else if ((rawTemp == ALL_ONES_TEMP_RAW) || (rawTemp == POWER_ON_TEMP_RAW))
+            {
+                if (!ReadDeviceRam(bus, &device[idx], ramData, 1))
+                {
+                    return false;
+                }
+                
+                isValid = device[idx].isDataValid && (ramData[0] == rxData[0]) && (ramData[1] == rxData[1]);
+            }
+            else
+            {
+                isValid = true;
+            }
+        }
+        
+        device[idx].isDataValid = isValid;
+        if (isValid)
+        {
+            dataBuff[idx] = RawToCelsius(bus, rxData);
+        }
+        else
+        {
+            isAllValid = false;
+        }
+        
+        UpdateHealth(bus, &device[idx], dataBuff[idx]);
+    }
+    
+    /* Terminate last scratch-pad read */
+    return OW_Reset(&bus->owBus) && isAllValid;
+}
+
+
+/*
+ *  Check raw temperature for sign extension and measurement range
+ */
+static bool IsTempPlausible(const uint8_t *rxData)
+{
+    int16_t rawTemp = (int16_t)(((uint16_t)rxData[1] << 8) | rxData[0]);
+    
+    /* Upper 5 bits of MSB are all copies of sign bit */
+    if (((rxData[1] & 0xF8) != 0x00) && ((rxData[1] & 0xF8) != 0xF8))
+    {
+        return false;
+    }
+    
+    /* Range -55 to +125 degC (1/16 degC units) */
+    return (rawTemp >= (MIN_TEMP * 16)) && (rawTemp <= (125 * 16));
+}
+
+
+/*
+ *  Convert raw temperature register (LSB, MSB) to Celsius with correction
+ */
+static float RawToCelsius(const DsBus_t *bus, const uint8_t *rxData)
+{
+    uint8_t intgr = ((rxData[1] & 0x07) << 4) | (rxData[0] >> 4);
+    uint8_t frctn = rxData[0] & 0x0F;
+    float signPart = (rxData[1] & 0x08) ? (-1.0) : (1.0);
+    
+    return ((float)intgr + (float)frctn / 16) * signPart + bus->tempCorr;
+}
+
+
+/*
+ *  Address a single device with its precomputed MATCH ROM frame
+ */
+static INLINE void MatchRom(DsBus_t *bus, const DsDevice_t *device)
+{
+    OW_WriteByte(&bus->owBus, MATCH_ROM_CMD);
+    OW_WriteMultiByte(&bus->owBus, (void *)&device->romFrame, 8);
+}
+
+
+/*
+ *  Check if device handle holds a MATCH ROM frame
+ */
+static INLINE bool IsDeviceValid(const DsDevice_t *device)
+{
+    return (device != NULL) && (device->romFrame != 0);
+}
+
+
+/*
+ *  Skip read of quarantined device (every "probeCycleCount" + 1-th read is
+ *  a probe)
+ */
+static bool IsReadSkipped(DsBus_t *bus, DsDevice_t *device)
+{
+    DsHealth_t *health = &device->health;
+    
+    if (!health->isQuarantined || (bus->quarantineFailCount == 0) || (health->skipCount == 0))
+    {
+        return false;
+    }
+    
+    health->skipCount--;
+    device->isDataValid = false;
+    bus->stats.quarantineSkipCount++;
+    
+    return true;
+}
+
+
+/*
+ *  Quarantined device is probed with a single read (no re-reads)
+ */
+static INLINE uint8_t GetRepeatCount(const DsDevice_t *device)
+{
+    return device->health.isQuarantined ? 1 : DS_READ_RAM_REPEAT_COUNT;
+}
+
+
+/*
+ *  Update health record with result of device's read, quarantine device
+ *  after too many consecutive failures and release it on a good read
+ */
+static void UpdateHealth(DsBus_t *bus, DsDevice_t *device, float temp)
+{
+    DsHealth_t *health = &device->health;
+    
+    health->readCount++;
+    
+    if (device->isDataValid)
+    {
+        health->failStreak = 0;
+        health->isQuarantined = false;
+        health->lastTemp = temp;
+        health->lastGoodTick = _CP0_GET_COUNT();
+    }
+    else
+    {
+        health->failCount++;
+        health->failStreak += (health->failStreak < UINT16_MAX) ? 1 : 0;
+        
+        if ((bus->quarantineFailCount > 0) && (health->failStreak >= bus->quarantineFailCount))
+        {
+            health->isQuarantined = true;
+            health->skipCount = bus->probeCycleCount;
+        }
+    }
+}
+
+
+/*
+ *  Mark data of devices as not read
+ */
+static void SetDataInvalid(DsDevice_t *device, const uint32_t deviceCount)
+{
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
+    {
+        device[idx].isDataValid = false;
+    }
+}
+
+
+/*
+ *  Forget settings of device known before last SKIP ROM write, copy or recall
+ */
+static void SyncShadow(DsBus_t *bus, DsDevice_t *device)
+{
+    if (device->shadow.epoch != bus->shadowEpoch)
+    {
+        device->shadow.isRamKnown = false;
+        device->shadow.isRomKnown = false;
+        device->shadow.epoch = bus->shadowEpoch;
+    }
+}
+
+
+/*
+ *  Record RAM settings written to or read from device (TH, TL, config) and
+ *  track its resolution for conversion time
+ */
+static void SetRamShadow(DsBus_t *bus, DsDevice_t *device, const uint8_t *cfgData)
+{
+    DsShadow_t *shadow = &device->shadow;
+    
+    SyncShadow(bus, device);
+    shadow->ramCfg[0] = cfgData[0];
+    shadow->ramCfg[1] = cfgData[1];
+    shadow->ramCfg[2] = (cfgData[2] & CONFIG_RES_MASK) | CONFIG_FIXED_BITS;
+    shadow->isRamKnown = true;
+    device->measRes = (DsMeasRes_t)((cfgData[2] & CONFIG_RES_MASK) >> 5);
+    device->resEpoch = bus->resEpoch;
+}
+
+
+/*
+ *  Record finished EEPROM copy (SAVE_ROM_MODE) or recall (COPY_ROM_MODE),
+ *  devices of a multi mode transfer have no handle
+ */
+static void CopyShadow(DsBus_t *bus, DsDevice_t *device, bool isMultiMode, RomMode_t romMode)
+{
+    if (isMultiMode)
+    {
+        bus->shadowEpoch++;
+        if (romMode == COPY_ROM_MODE)
+        {
+            bus->resEpoch++;
+        }
+        return;
+    }
+    
+    DsShadow_t *shadow = &device->shadow;
+    
+    SyncShadow(bus, device);
+    for (uint8_t byteIdx = 0; byteIdx < 3; byteIdx++)
+    {
+        if (romMode == SAVE_ROM_MODE)
+        {
+            shadow->romCfg[byteIdx] = shadow->ramCfg[byteIdx];
+        }
+        else
+        {
+            shadow->ramCfg[byteIdx] = shadow->romCfg[byteIdx];
+        }
+    }
+    
+    if (romMode == SAVE_ROM_MODE)
+    {
+        shadow->isRomKnown = shadow->isRamKnown;
+    }
+    /* Recalled resolution unknown unless EEPROM known (longest tCONV) */
+    else
+    {
+        shadow->isRamKnown = shadow->isRomKnown;
+        device->measRes = shadow->isRomKnown ? (DsMeasRes_t)((shadow->romCfg[2] & CONFIG_RES_MASK) >> 5) : DS_MEAS_RES_12BIT;
+        device->resEpoch = bus->resEpoch;
+    }
+}
+
+
+/*
+ *  Forget settings of device (or of all devices in multi mode) after a
+ *  failed EEPROM transfer
+ */
+static void ForgetShadow(DsBus_t *bus, DsDevice_t *device, bool isMultiMode)
+{
+    if (isMultiMode)
+    {
+        bus->shadowEpoch++;
+        bus->resEpoch++;
+        return;
+    }
+    
+    SyncShadow(bus, device);
+    device->shadow.isRamKnown = false;
+    device->shadow.isRomKnown = false;
+    device->measRes = DS_MEAS_RES_12BIT;
+}
+
+
+/*
+ *  Keep settings known for handles across a SKIP ROM transfer (bus epoch
+ *  bumped since "epoch", devices without handle go stale)
+ */
+static void CarryShadow(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount, uint32_t epoch)
+{
+    for (uint32_t idx = 0; (device != NULL) && (idx < deviceCount); idx++)
+    {
+        if (device[idx].shadow.epoch == epoch)
+        {
+            device[idx].shadow.epoch = bus->shadowEpoch;
+        }
+    }
+}
+
+
+/*
+ *  Count handles whose RAM settings differ from "cfgData" (all handles if
+ *  the RAM settings of any of them are unknown)
+ */
+static uint32_t GetRamChangeCount(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount, const uint8_t *cfgData)
+{
+    uint32_t changeCount = 0;
+    
+    if (!IsRamKnown(bus, device, deviceCount))
+    {
+        return deviceCount;
+    }
+    
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
+    {
+        changeCount += IsRamEqual(bus, &device[idx], cfgData) ? 0 : 1;
+    }
+    
+    return changeCount;
+}
+
+
+/*
+ *  Count handles whose EEPROM is not known to hold their RAM settings (all
+ *  handles if the RAM settings of any of them are unknown)
+ */
+static uint32_t GetRomChangeCount(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount)
+{
+    uint32_t changeCount = 0;
+    
+    if (!IsRamKnown(bus, device, deviceCount))
+    {
+        return deviceCount;
+    }
+    
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
+    {
+        changeCount += IsRomEqual(bus, &device[idx]) ? 0 : 1;
+    }
+    
+    return changeCount;
+}
+
+
+/*
+ *  Check if RAM settings of all handles are known
+ */
+static bool IsRamKnown(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount)
+{
+    if ((device == NULL) || (deviceCount == 0))
+    {
+        return false;
+    }
+    
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
+    {
+        SyncShadow(bus, &device[idx]);
+        if (!IsDeviceValid(&device[idx]) || !device[idx].shadow.isRamKnown)
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+/*
+ *  Check if RAM of device is known to hold settings (TH, TL, config)
+ */
+static bool IsRamEqual(DsBus_t *bus, DsDevice_t *device, const uint8_t *cfgData)
+{
+    DsShadow_t *shadow = &device->shadow;
+    
+    SyncShadow(bus, device);
+    
+    return shadow->isRamKnown && (shadow->ramCfg[0] == cfgData[0]) && (shadow->ramCfg[1] == cfgData[1]) &&
+           (shadow->ramCfg[2] == ((cfgData[2] & CONFIG_RES_MASK) | CONFIG_FIXED_BITS));
+}
+
+
+/*
+ *  Check if EEPROM of device is known to hold its RAM settings
+ */
+static bool IsRomEqual(DsBus_t *bus, DsDevice_t *device)
+{
+    DsShadow_t *shadow = &device->shadow;
+    
+    SyncShadow(bus, device);
+    
+    return shadow->isRamKnown && shadow->isRomKnown && (shadow->ramCfg[0] == shadow->romCfg[0]) &&
+           (shadow->ramCfg[1] == shadow->romCfg[1]) && (shadow->ramCfg[2] == shadow->romCfg[2]);
+}
+
+
+/*
+ *  Count failed scratch-pad read of device
+ */
+static INLINE void CountCrcFail(DsBus_t *bus, DsDevice_t *device)
+{
+    bus->stats.crcFailCount++;
+    device->crcFailCount++;
+}
+
+
+/*
+ *  Convert on single device (set to 9-bit resolution) and check if it is not
+ *  done after 9-bit conversion time, false on lost presence
+ */
+static bool CheckConvSlow(DsBus_t *bus, DsDevice_t *device, bool *isSlow)
+{
+    /* Re-initialize bus */
+    if (!OW_Reset(&bus->owBus))
+    {
+        return false;
+    }
+    
+    /* Match ROM + convert */
+    MatchRom(bus, device);
+    OW_WriteByte(&bus->owBus, CONV_TEMP_CMD);
+    
+    /* Wait for conversion done */
+    uint32_t deadline = GetDeadline(bus, GetConvTimeMs(DS_MEAS_RES_9BIT));
+    while (!IsDeadlinePassed(deadline));
+    
+    /* Check if not done after 9-bit conversion time */
+    *isSlow = !OW_ReadBit(&bus->owBus);
+    
+    return true;
+}
+
+
+/*
+ *  Check reserved scratch-pad bytes for their fixed datasheet values
+ */
+static INLINE bool IsReservedValid(const uint8_t *rxData)
+{
+    return (rxData[5] == RESERVED_BYTE5) && (rxData[7] == RESERVED_BYTE7);
+}
+
+
+/*
+ *  Convert core timer ticks (SYSCLK/2) to microseconds
+ */
+static uint32_t TicksToUs(const DsBus_t *bus, uint64_t coreTicks)
+{
+    uint32_t sysFreq = (bus->sysFreq != 0) ? bus->sysFreq : DEFAULT_SYSFREQ;
+    
+    return (uint32_t)((coreTicks * 2000000) / sysFreq);
+}
+
+
+/*
+ *  Core timer value after given timeout (core timer runs at SYSCLK/2)
+ */
+static uint32_t GetDeadline(DsBus_t *bus, uint32_t timeoutMs)
+{
+    return GetDeadlineUs(bus, timeoutMs * 1000);
+}
+
+
+/*
+ *  Get core timer value after "timeoutUs" microseconds
+ */
+static uint32_t GetDeadlineUs(DsBus_t *bus, uint32_t timeoutUs)
+{
+    /* SYSCLK default value */
+    if (bus->sysFreq == 0)
+    {
+        bus->sysFreq = DEFAULT_SYSFREQ;
+    }
+    
+    return _CP0_GET_COUNT() + (uint32_t)(((uint64_t)timeoutUs * bus->sysFreq) / 2000000);
+}
+
+
+/*
+ *  Check if core timer passed the deadline (safe across counter overflow)
+ */
+static bool IsDeadlinePassed(uint32_t deadline)
+{
+    return ((int32_t)(_CP0_GET_COUNT() - deadline) >= 0);
+}
+
+
+/*
+ *  Datasheet conversion time of given resolution with margin (rounded up)
+ */
+static uint32_t GetConvTimeMs(DsMeasRes_t measRes)
+{
+    uint32_t convTimeUs = CONV_TEMP_9BIT_US << (measRes & 0x03);
+    
+    return (convTimeUs * (100 + DS_CONV_TEMP_MARGIN_PCT) / 100 + 999) / 1000;
+}
+
+
+/*
+ *  Highest tracked resolution of devices (12-bit if devices not given or if a
+ *  SKIP ROM write or recall may have changed it since last tracked)
+ */
+static DsMeasRes_t GetMaxMeasRes(const DsBus_t *bus, const DsDevice_t *device, const uint32_t deviceCount)
+{
+    DsMeasRes_t measRes = DS_MEAS_RES_9BIT;
+    
+    if (device == NULL)
+    {
+        return DS_MEAS_RES_12BIT;
+    }
+    
+    for (uint32_t idx = 0; idx < deviceCount; idx++)
+    {
+        if (device[idx].resEpoch != bus->resEpoch)
+        {
+            return DS_MEAS_RES_12BIT;
+        }
+        
+        measRes = (device[idx].measRes > measRes) ? device[idx].measRes : measRes;
+    }
+    
+    return measRes;
+}
+
+
+/*
+ *  Check if conversion time of last parasite conversion elapsed (deadline
+ *  dropped once passed, so it is not seen as pending after timer overflow)
+ */
+static bool IsConvTimeOver(DsBus_t *bus)
+{
+    if (bus->isConvPending && IsDeadlinePassed(bus->convDeadline))
+    {
+        bus->isConvPending = false;
+    }
+    
+    return !bus->isConvPending;
+}
+
+
+/*
+ *  Check if bus may be accessed (no parasite conversion or EEPROM copy
+ *  powered by strong pull-up) and end strong pull-up of a finished one
+ */
+static bool IsBusReady(DsBus_t *bus)
+{
+    if (!IsConvTimeOver(bus))
     {
         return false;
     }
     
+    if (bus->isParasite)
+    {
+        OW_SetPullup(&bus->owBus, false);
+    }
+    
     return true;
 }
\ No newline at end of file
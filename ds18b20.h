@@ -17,13 +17,28 @@
 /******************************************************************************/
 
 /** Number of iterations if CRC validation fails **/
+#ifndef DS_READ_RAM_REPEAT_COUNT
 #define DS_READ_RAM_REPEAT_COUNT        3       // Scratch-pad read
+#endif
+#ifndef DS_SEARCH_DEVICE_REPEAT_COUNT
 #define DS_SEARCH_DEVICE_REPEAT_COUNT   3       // Search device ID
+#endif
 
-/** Timeout for polling-based operations **/
+/** Timeout for polling-based operations (may be overridden at build time) **/
+#ifndef DS_SAVE_COPY_ROM_TIMEOUT_MS
 #define DS_SAVE_COPY_ROM_TIMEOUT_MS     100
-#define DS_CONV_TEMP_TIMEOUT_MS         1000    // Must be more than 755 ms
-#define DS_SEARCH_ID_TIMEOUT_MS         1000
+#endif
+#ifndef DS_CONV_TEMP_MARGIN_PCT
+#define DS_CONV_TEMP_MARGIN_PCT         10      // Added to datasheet tCONV
+#endif
+#ifndef DS_SEARCH_ID_TIMEOUT_MS
+#define DS_SEARCH_ID_TIMEOUT_MS         100     // Per search pass (one device, approx. 15 ms)
+#endif
+
+/** Max. devices checked by one DS18B20_FindFakeDevices call (6 B of stack each) **/
+#ifndef DS_MAX_FAKE_CHECK_COUNT
+#define DS_MAX_FAKE_CHECK_COUNT         64
+#endif
 
 /******************************************************************************/
 /*----------------------------Enumeration Types-------------------------------*/
@@ -36,41 +51,179 @@ typedef enum {
     DS_MEAS_RES_12BIT = 3
 } DsMeasRes_t;
 
+/** Non-blocking job state (conversion, search or EEPROM transfer) **/
+typedef enum {
+    DS_CONV_IDLE = 0,
+    DS_CONV_BUSY = 1,       // Job in progress
+    DS_CONV_READY = 2,      // Conversion done, scratch-pads not read yet
+    DS_CONV_DONE = 3,       // Results stored in data buffer (search: devices found)
+    DS_CONV_TIMEOUT = 4,    // Deadline passed before job done
+    DS_CONV_ERROR = 5       // Bus or CRC failure
+} DsConvState_t;
+
 /******************************************************************************/
 /*-----------------------------Data Structures--------------------------------*/
 /******************************************************************************/
 
+/** Health record of a device (updated by DS18B20_ReadTemp) **/
+typedef struct {
+    uint32_t        readCount;      // Temperature reads (error rate = failCount / readCount)
+    uint32_t        failCount;      // Reads failing all re-reads
+    uint16_t        failStreak;     // Consecutive failed reads
+    uint16_t        skipCount;      // Quarantine: reads to skip before next probe
+    bool            isQuarantined;
+    float           lastTemp;       // Last good sample (Celsius, with correction)
+    uint32_t        lastGoodTick;   // Core timer value of last good sample
+} DsHealth_t;
+
+/** Alarm/resolution settings known to be in a device (write avoidance) **/
+typedef struct {
+    uint8_t         ramCfg[3];      // Scratch-pad TH, TL, config
+    uint8_t         romCfg[3];      // EEPROM TH, TL, config
+    bool            isRamKnown;
+    bool            isRomKnown;
+    uint32_t        epoch;          // Stale unless equal to DsBus_t.shadowEpoch
+} DsShadow_t;
+
+/** Known device (filled by search or DS18B20_InitDevice, used by all accesses) **/
+typedef struct {
+    uint64_t        romId;      // 48-bit serial number
+    uint64_t        romFrame;   // MATCH ROM frame (family code, serial, CRC)
+    DsMeasRes_t     measRes;    // Resolution last written or read (sets conversion time, 12-bit if unknown)
+    uint32_t        resEpoch;   // Resolution stale unless equal to DsBus_t.resEpoch
+    uint32_t        crcFailCount; // Scratch-pad CRC/plausibility failures
+    bool            isDataValid; // Last read of this device passed CRC/plausibility
+    DsHealth_t      health;
+    DsShadow_t      shadow;     // Settings known from reads and writes of this device
+} DsDevice_t;
+
+/** Driver counters of a bus (accumulated since DS18B20_InitBus or DS18B20_ResetStats) **/
+typedef struct {
+    uint32_t        resetCount;
+    uint32_t        presenceFailCount;
+    uint32_t        bitCount;           // Read/write slots (bytes = bitCount / 8)
+    uint32_t        crcFailCount;       // Scratch-pad CRC/plausibility failures (all devices)
+    uint32_t        retryCount;         // Scratch-pad re-reads
+    uint32_t        searchRestartCount; // ROM searches restarted (lost presence or ROM CRC)
+    uint32_t        quarantineSkipCount; // Reads of quarantined devices skipped
+    uint32_t        writeSkipCount;     // Scratch-pad writes and EEPROM copies skipped (no change)
+    uint64_t        busyUs;             // Time spent in OW transfers
+    uint32_t        maxMaskedUs;        // Longest interrupt-masked window
+} DsStats_t;
+
+/** DS18B20 bus context (one per OW bus or pin group, owned by caller) **/
+typedef struct {
+    OwBus_t         owBus;
+    uint32_t        sysFreq;    // Core timer timebase of deadlines
+    float           tempCorr;
+    bool            isFastRead;
+    DsStats_t       stats;      // Driver counters (OW counters kept in owBus.stats)
+    uint16_t        quarantineFailCount; // Failed reads before quarantine (0 - off)
+    uint16_t        probeCycleCount; // Quarantined device reads skipped between probes
+    bool            isParasite; // Parasite powered device on bus (DS18B20_DetectPowerMode)
+    bool            isConvPending; // Parasite: strong pull-up held until "convDeadline"
+    uint32_t        convDeadline; // Core timer value at end of tCONV (tWR) of last conversion (EEPROM copy)
+    uint32_t        shadowEpoch; // Bumped by SKIP ROM writes, copies and recalls (shadows go stale)
+    uint32_t        resEpoch;   // Bumped by SKIP ROM writes and recalls (tracked resolutions go stale)
+} DsBus_t;
+
 /** DS18B20 configuration parameters **/
 typedef struct {
-    OwConfig_t      owConfig;
     DsMeasRes_t     measRes;
-    uint64_t        deviceId;   // Only applicable for single device config mode
+    DsDevice_t      *device;    // Single mode: device, multi mode: handles of all devices on bus
+    uint32_t        deviceCount; // Multi mode: handles in device array (optional, needed to skip writes)
     int             lowAlarm;
     int             highAlarm;
+    bool            isSaved;    // Also save settings to EEPROM (DS18B20_SaveToRom)
 } DsConfig_t;
 
+/** Non-blocking conversion job (owned by caller until DONE/TIMEOUT/ERROR) **/
+typedef struct {
+    DsBus_t         *bus;
+    DsDevice_t      *device;
+    float           *dataBuff;
+    uint32_t        deviceCount;
+    uint32_t        deadline;   // Core timer value (max. tCONV of devices + margin)
+    DsConvState_t   state;
+} DsConvJob_t;
+
+/** Non-blocking ROM search job (one pass of search tree per DS18B20_PollSearch) **/
+typedef struct {
+    DsBus_t         *bus;
+    DsDevice_t      *deviceBuff;
+    uint32_t        deviceCount; // Devices found (0 unless DONE)
+    uint64_t        lastRomData; // ROM found by previous pass
+    int             lastDiscrepancy; // Branch taken by next pass (-1 - none left)
+    uint8_t         searchCmd;
+    uint8_t         repeatCount; // Restarts after lost presence or ROM CRC failure
+    OwSpeedMode_t   speedMode;  // Restored when done (search runs at standard speed)
+    uint32_t        deadline;   // Core timer value (current pass)
+    DsConvState_t   state;
+} DsSearchJob_t;
+
+/** Non-blocking EEPROM copy or recall job (owned by caller until DONE/TIMEOUT/ERROR) **/
+typedef struct {
+    DsBus_t         *bus;
+    DsDevice_t      *device;    // Device of current transfer (multi mode: NULL or ignored)
+    DsDevice_t      *handle;    // Configuration save: handles of bus
+    uint32_t        handleCount;
+    uint32_t        handleIdx;  // Next handle saved one by one
+    uint32_t        epoch;      // Shadow epoch before SKIP ROM save of handles
+    bool            isMultiMode; // Current transfer addressed by SKIP ROM
+    bool            isRecall;
+    uint32_t        deadline;   // Core timer value (parasite save: datasheet tWR)
+    DsConvState_t   state;
+} DsRomJob_t;
+
 /******************************************************************************/
 /*---------------------------- Function Prototypes----------------------------*/
 /******************************************************************************/
 
+/** Bus functions **/
+bool DS18B20_InitBus(DsBus_t *bus, OwConfig_t owConfig);
+void DS18B20_GetStats(DsBus_t *bus, DsStats_t *stats);
+void DS18B20_ResetStats(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount);
+
 /** Search functions **/
-uint32_t DS18B20_SearchDeviceId(const uint32_t pinCode, uint64_t *romIdBuff);
-uint32_t DS18B20_SearchAlarm(const uint32_t pinCode, uint64_t *romIdBuff);
+uint32_t DS18B20_SearchDeviceId(DsBus_t *bus, DsDevice_t *deviceBuff);
+uint32_t DS18B20_SearchAlarm(DsBus_t *bus, DsDevice_t *deviceBuff);
+bool DS18B20_InitDevice(DsDevice_t *device, uint64_t romId);
 
 /** Configuration functions **/
-bool DS18B20_ConfigDevice(DsConfig_t dsConfig, bool isMultiMode);
-bool DS18B20_SaveToRom(const uint64_t *romId, bool isMultiMode);
-bool DS18B20_CopyFromRom(const uint64_t *romId, bool isMultiMode);
-bool DS18B20_SetCorrection(float corr);
+bool DS18B20_ConfigDevice(DsBus_t *bus, DsConfig_t dsConfig, bool isMultiMode);
+bool DS18B20_SaveToRom(DsBus_t *bus, DsDevice_t *device, bool isMultiMode);
+bool DS18B20_CopyFromRom(DsBus_t *bus, DsDevice_t *device, bool isMultiMode);
+bool DS18B20_LoadConfig(DsBus_t *bus, DsDevice_t *device, const uint32_t deviceCount);
+bool DS18B20_SetCorrection(DsBus_t *bus, float corr);
+void DS18B20_SetFastRead(DsBus_t *bus, bool isFastRead);
+void DS18B20_SetQuarantine(DsBus_t *bus, uint16_t failCount, uint16_t probeCycleCount);
+bool DS18B20_DetectPowerMode(DsBus_t *bus, bool *isParasite);
 
 /** Operation functions **/
-bool DS18B20_IsConvDone(void);
-bool DS18B20_ConvertReadTemp(const uint64_t *romId, float *dataBuff, const uint8_t deviceCount);
-bool DS18B20_ConvertTemp(const uint64_t *romId, const uint32_t deviceCount);
-bool DS18B20_ReadTemp(const uint64_t *romId, float *dataBuff, const uint32_t deviceCount);
-bool DS18B20_ReadRam(const uint64_t *romId, int *dataBuff, const uint32_t deviceCount);
+bool DS18B20_IsConvDone(DsBus_t *bus);
+bool DS18B20_ConvertReadTemp(DsBus_t *bus, DsDevice_t *device, float *dataBuff, const uint8_t deviceCount);
+bool DS18B20_ConvertTemp(DsBus_t *bus, const DsDevice_t *device, const uint32_t deviceCount);
+bool DS18B20_ReadTemp(DsBus_t *bus, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount);
+bool DS18B20_ReadRam(DsBus_t *bus, DsDevice_t *device, int *dataBuff, const uint32_t deviceCount);
+
+/** Multi-bus functions (bus initialized with a pin group) **/
+bool DS18B20_ReadTempMulti(DsBus_t *bus, DsDevice_t *device, float *dataBuff);
+
+/** Non-blocking conversion functions **/
+bool DS18B20_StartConv(DsBus_t *bus, DsConvJob_t *job, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount);
+DsConvState_t DS18B20_PollConv(DsConvJob_t *job);
+DsConvState_t DS18B20_CompleteConv(DsConvJob_t *job);
+
+/** Non-blocking search and EEPROM functions **/
+bool DS18B20_StartSearch(DsBus_t *bus, DsSearchJob_t *job, DsDevice_t *deviceBuff, bool isAlarm);
+DsConvState_t DS18B20_PollSearch(DsSearchJob_t *job);
+bool DS18B20_StartConfig(DsBus_t *bus, DsRomJob_t *job, DsConfig_t dsConfig, bool isMultiMode);
+bool DS18B20_StartSave(DsBus_t *bus, DsRomJob_t *job, DsDevice_t *device, bool isMultiMode);
+bool DS18B20_StartRecall(DsBus_t *bus, DsRomJob_t *job, DsDevice_t *device, bool isMultiMode);
+DsConvState_t DS18B20_PollRom(DsRomJob_t *job);
 
 /** Other functions **/
-bool DS18B20_IsDeviceFake(const uint64_t *romId);
+bool DS18B20_IsDeviceFake(DsBus_t *bus, DsDevice_t *device);
+bool DS18B20_FindFakeDevices(DsBus_t *bus, DsDevice_t *device, bool *isFakeBuff, const uint32_t deviceCount);
 
 #endif	/* DS18B20_H */
\ No newline at end of file
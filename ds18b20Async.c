@@ -0,0 +1,392 @@
+#include "ds18b20Async.h"
+
+/*
+ *  Queued non-blocking DS18B20 operations
+ *
+ *  Requests of a bus are queued and executed in order by DS18B20_AsyncTick(),
+ *  called from the main loop or a periodic timer ISR. Every call runs one
+ *  bounded step of the request at the queue head - a reset and command,
+ *  a single done poll of a conversion or EEPROM transfer (at most every
+ *  DS_ASYNC_POLL_US), one pass of the ROM search tree or the scratch-pad
+ *  read of one device - so no call blocks for a whole conversion, EEPROM
+ *  write or bus scan. The completion callback gets the request's status and
+ *  result after it was removed from the queue, so it may queue follow-ups.
+ */
+
+/** SYSCLK assumed if bus was set up without it **/
+#define DEFAULT_SYSFREQ         8000000
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static bool QueueReq(DsAsync_t *async, DsAsyncReq_t req);
+static void StartReq(DsAsync_t *async, DsAsyncReq_t *req);
+static void PollReq(DsAsync_t *async, DsAsyncReq_t *req);
+static void ReadReq(DsAsync_t *async, DsAsyncReq_t *req);
+static void FinishJob(DsAsync_t *async, DsConvState_t state, uint32_t result);
+static void FinishReq(DsAsync_t *async, DsAsyncStatus_t status, uint32_t result);
+static bool IsPollDue(DsAsync_t *async, bool isTimed);
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Set up empty request queue of bus (bus initialized by DS18B20_InitBus)
+ */
+extern bool DS18B20_AsyncInit(DsAsync_t *async, DsBus_t *bus)
+{
+    /* Inputs check */
+    if ((async == NULL) || (bus == NULL))
+    {
+        return false;
+    }
+
+    uint32_t sysFreq = (bus->sysFreq != 0) ? bus->sysFreq : DEFAULT_SYSFREQ;
+
+    async->bus = bus;
+    async->headIdx = 0;
+    async->reqCount = 0;
+    async->state = DS_ASYNC_IDLE;
+    async->pollTicks = (uint32_t)(((uint64_t)DS_ASYNC_POLL_US * sysFreq) / 2000000);
+
+    return true;
+}
+
+
+/*
+ *  Queue search of all devices (device buffer filled in ROM order)
+ */
+extern bool DS18B20_AsyncSearch(DsAsync_t *async, DsDevice_t *deviceBuff, DsAsyncCallback_t callback, void *context)
+{
+    return QueueReq(async, (DsAsyncReq_t){.op = DS_ASYNC_SEARCH, .device = deviceBuff,
+                                          .callback = callback, .context = context});
+}
+
+
+/*
+ *  Queue search of devices with alarm flag set
+ */
+extern bool DS18B20_AsyncSearchAlarm(DsAsync_t *async, DsDevice_t *deviceBuff, DsAsyncCallback_t callback, void *context)
+{
+    return QueueReq(async, (DsAsyncReq_t){.op = DS_ASYNC_SEARCH_ALARM, .device = deviceBuff,
+                                          .callback = callback, .context = context});
+}
+
+
+/*
+ *  Queue conversion of given devices and read of their temperature
+ */
+extern bool DS18B20_AsyncConvert(DsAsync_t *async, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount, DsAsyncCallback_t callback, void *context)
+{
+    return QueueReq(async, (DsAsyncReq_t){.op = DS_ASYNC_CONVERT, .device = device, .dataBuff = dataBuff,
+                                          .deviceCount = deviceCount, .callback = callback, .context = context});
+}
+
+
+/*
+ *  Queue temperature read of finished conversion
+ */
+extern bool DS18B20_AsyncRead(DsAsync_t *async, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount, DsAsyncCallback_t callback, void *context)
+{
+    return QueueReq(async, (DsAsyncReq_t){.op = DS_ASYNC_READ, .device = device, .dataBuff = dataBuff,
+                                          .deviceCount = deviceCount, .callback = callback, .context = context});
+}
+
+
+/*
+ *  Queue alarm and resolution configuration (and its EEPROM save if
+ *  "isSaved")
+ */
+extern bool DS18B20_AsyncConfig(DsAsync_t *async, DsConfig_t dsConfig, bool isMultiMode, DsAsyncCallback_t callback, void *context)
+{
+    return QueueReq(async, (DsAsyncReq_t){.op = DS_ASYNC_CONFIG, .dsConfig = dsConfig, .isMultiMode = isMultiMode,
+                                          .callback = callback, .context = context});
+}
+
+
+/*
+ *  Queue copy of RAM settings to EEPROM
+ */
+extern bool DS18B20_AsyncSave(DsAsync_t *async, DsDevice_t *device, bool isMultiMode, DsAsyncCallback_t callback, void *context)
+{
+    return QueueReq(async, (DsAsyncReq_t){.op = DS_ASYNC_SAVE, .device = device, .isMultiMode = isMultiMode,
+                                          .callback = callback, .context = context});
+}
+
+
+/*
+ *  Queue reload of EEPROM settings to RAM
+ */
+extern bool DS18B20_AsyncRecall(DsAsync_t *async, DsDevice_t *device, bool isMultiMode, DsAsyncCallback_t callback, void *context)
+{
+    return QueueReq(async, (DsAsyncReq_t){.op = DS_ASYNC_RECALL, .device = device, .isMultiMode = isMultiMode,
+                                          .callback = callback, .context = context});
+}
+
+
+/*
+ *  Check if requests are queued or in progress
+ */
+extern bool DS18B20_AsyncIsBusy(const DsAsync_t *async)
+{
+    return (async->reqCount > 0);
+}
+
+
+/*
+ *  Run next step of request at queue head (call from main loop or tick ISR)
+ */
+extern void DS18B20_AsyncTick(DsAsync_t *async)
+{
+    if (async->reqCount == 0)
+    {
+        return;
+    }
+
+    DsAsyncReq_t *req = &async->queue[async->headIdx];
+
+    switch (async->state)
+    {
+        case DS_ASYNC_IDLE:
+            StartReq(async, req);
+            break;
+
+        case DS_ASYNC_BUSY:
+            PollReq(async, req);
+            break;
+
+        default:
+            ReadReq(async, req);
+            break;
+    }
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Append request to queue (interrupts masked, tick may run in ISR)
+ */
+static bool QueueReq(DsAsync_t *async, DsAsyncReq_t req)
+{
+    if ((async == NULL) || (async->bus == NULL))
+    {
+        return false;
+    }
+
+    /* Obtain old interrupt status and disable interrupts */
+    uint32_t intrStatus = IC_GetInterruptState();
+    IC_DisableInterrupts();
+
+    if (async->reqCount >= DS_ASYNC_QUEUE_SIZE)
+    {
+        IC_SetInterruptState(intrStatus);
+        return false;
+    }
+
+    async->queue[(async->headIdx + async->reqCount) % DS_ASYNC_QUEUE_SIZE] = req;
+    async->reqCount++;
+
+    /* Restore interrupt state */
+    IC_SetInterruptState(intrStatus);
+
+    return true;
+}
+
+
+/*
+ *  Start transaction of request (search: first reset, conversion: command,
+ *  configuration: RAM write and first EEPROM copy)
+ */
+static void StartReq(DsAsync_t *async, DsAsyncReq_t *req)
+{
+    DsBus_t *bus = async->bus;
+    bool isStarted;
+    DsConvState_t *state;
+
+    async->pollTick = _CP0_GET_COUNT() + async->pollTicks;
+
+    switch (req->op)
+    {
+        case DS_ASYNC_SEARCH:
+        case DS_ASYNC_SEARCH_ALARM:
+            isStarted = DS18B20_StartSearch(bus, &async->searchJob, req->device, (req->op == DS_ASYNC_SEARCH_ALARM));
+            state = &async->searchJob.state;
+            break;
+
+        case DS_ASYNC_CONVERT:
+            isStarted = DS18B20_StartConv(bus, &async->convJob, req->device, req->dataBuff, req->deviceCount);
+            state = &async->convJob.state;
+            break;
+
+        /* No bus access until first read */
+        case DS_ASYNC_READ:
+            async->state = DS_ASYNC_READING;
+            async->readIdx = 0;
+            async->validCount = 0;
+            ReadReq(async, req);
+            return;
+
+        case DS_ASYNC_CONFIG:
+            isStarted = DS18B20_StartConfig(bus, &async->romJob, req->dsConfig, req->isMultiMode);
+            state = &async->romJob.state;
+            break;
+
+        case DS_ASYNC_SAVE:
+            isStarted = DS18B20_StartSave(bus, &async->romJob, req->device, req->isMultiMode);
+            state = &async->romJob.state;
+            break;
+
+        default:
+            isStarted = DS18B20_StartRecall(bus, &async->romJob, req->device, req->isMultiMode);
+            state = &async->romJob.state;
+            break;
+    }
+
+    /* Done at once (e.g. unchanged settings) or failed */
+    FinishJob(async, isStarted ? *state : DS_CONV_ERROR, 0);
+}
+
+
+/*
+ *  Advance job of request - one search pass per call, conversion and EEPROM
+ *  transfer polled every DS_ASYNC_POLL_US
+ */
+static void PollReq(DsAsync_t *async, DsAsyncReq_t *req)
+{
+    switch (req->op)
+    {
+        case DS_ASYNC_SEARCH:
+        case DS_ASYNC_SEARCH_ALARM:
+            DS18B20_PollSearch(&async->searchJob);
+            FinishJob(async, async->searchJob.state, async->searchJob.deviceCount);
+            break;
+
+        case DS_ASYNC_CONVERT:
+            if (!IsPollDue(async, async->bus->isParasite))
+            {
+                break;
+            }
+
+            /* Conversion done, scratch-pads read from next call */
+            if (DS18B20_PollConv(&async->convJob) == DS_CONV_READY)
+            {
+                async->state = DS_ASYNC_READING;
+                async->readIdx = 0;
+                async->validCount = 0;
+            }
+            else
+            {
+                FinishJob(async, async->convJob.state, 0);
+            }
+            break;
+
+        default:
+            if (IsPollDue(async, async->bus->isParasite && !async->romJob.isRecall))
+            {
+                DS18B20_PollRom(&async->romJob);
+                FinishJob(async, async->romJob.state, 0);
+            }
+            break;
+    }
+}
+
+
+/*
+ *  Read temperature of next device of request
+ */
+static void ReadReq(DsAsync_t *async, DsAsyncReq_t *req)
+{
+    uint32_t idx = async->readIdx++;
+
+    /* Inputs check (devices checked by DS18B20_ReadTemp) */
+    if ((req->device == NULL) || (req->dataBuff == NULL) || (req->deviceCount == 0))
+    {
+        FinishReq(async, DS_ASYNC_ERROR, 0);
+        return;
+    }
+
+    if (DS18B20_ReadTemp(async->bus, &req->device[idx], &req->dataBuff[idx], 1))
+    {
+        async->validCount++;
+    }
+
+    if (async->readIdx >= req->deviceCount)
+    {
+        FinishReq(async, (async->validCount == req->deviceCount) ? DS_ASYNC_OK : DS_ASYNC_ERROR,
+                  async->validCount);
+    }
+}
+
+
+/*
+ *  Finish request once its job left BUSY state
+ */
+static void FinishJob(DsAsync_t *async, DsConvState_t state, uint32_t result)
+{
+    switch (state)
+    {
+        case DS_CONV_BUSY:
+            async->state = DS_ASYNC_BUSY;
+            break;
+
+        case DS_CONV_DONE:
+            FinishReq(async, DS_ASYNC_OK, result);
+            break;
+
+        case DS_CONV_TIMEOUT:
+            FinishReq(async, DS_ASYNC_TIMEOUT, result);
+            break;
+
+        default:
+            FinishReq(async, DS_ASYNC_ERROR, result);
+            break;
+    }
+}
+
+
+/*
+ *  Remove request from queue and report its completion
+ */
+static void FinishReq(DsAsync_t *async, DsAsyncStatus_t status, uint32_t result)
+{
+    DsAsyncReq_t req = async->queue[async->headIdx];
+
+    /* Obtain old interrupt status and disable interrupts */
+    uint32_t intrStatus = IC_GetInterruptState();
+    IC_DisableInterrupts();
+
+    async->headIdx = (async->headIdx + 1) % DS_ASYNC_QUEUE_SIZE;
+    async->reqCount--;
+
+    /* Restore interrupt state */
+    IC_SetInterruptState(intrStatus);
+
+    async->state = DS_ASYNC_IDLE;
+
+    if (req.callback != NULL)
+    {
+        req.callback(req.context, req.op, status, result);
+    }
+}
+
+
+/*
+ *  Check if conversion or EEPROM transfer is due for next poll (jobs timed
+ *  by strong pull-up don't access the bus, due every call)
+ */
+static bool IsPollDue(DsAsync_t *async, bool isTimed)
+{
+    uint32_t nowTick = _CP0_GET_COUNT();
+
+    if (!isTimed && ((int32_t)(nowTick - async->pollTick) < 0))
+    {
+        return false;
+    }
+    async->pollTick = nowTick + async->pollTicks;
+
+    return true;
+}
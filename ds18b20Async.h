@@ -0,0 +1,105 @@
+#ifndef DS18B20ASYNC_H
+#define	DS18B20ASYNC_H
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "ds18b20.h"
+
+/******************************************************************************/
+/*---------------------------------Macros-------------------------------------*/
+/******************************************************************************/
+
+/** Max. amount of queued requests per bus **/
+#ifndef DS_ASYNC_QUEUE_SIZE
+#define DS_ASYNC_QUEUE_SIZE         8
+#endif
+
+/** Conversion done bit and EEPROM transfers polled at most once per interval **/
+#ifndef DS_ASYNC_POLL_US
+#define DS_ASYNC_POLL_US            1000
+#endif
+
+/******************************************************************************/
+/*----------------------------Enumeration Types-------------------------------*/
+/******************************************************************************/
+
+/** Queued operation type **/
+typedef enum {
+    DS_ASYNC_SEARCH = 0,        // DS18B20_SearchDeviceId
+    DS_ASYNC_SEARCH_ALARM = 1,  // DS18B20_SearchAlarm
+    DS_ASYNC_CONVERT = 2,       // DS18B20_ConvertReadTemp
+    DS_ASYNC_READ = 3,          // DS18B20_ReadTemp
+    DS_ASYNC_CONFIG = 4,        // DS18B20_ConfigDevice
+    DS_ASYNC_SAVE = 5,          // DS18B20_SaveToRom
+    DS_ASYNC_RECALL = 6         // DS18B20_CopyFromRom
+} DsAsyncOp_t;
+
+/** Completion status of a request **/
+typedef enum {
+    DS_ASYNC_OK = 0,
+    DS_ASYNC_ERROR = 1,         // Lost presence, invalid device or data failing all re-reads
+    DS_ASYNC_TIMEOUT = 2        // Deadline of conversion, EEPROM transfer or search passed
+} DsAsyncStatus_t;
+
+/** Progress of request at queue head **/
+typedef enum {
+    DS_ASYNC_IDLE = 0,          // Not started
+    DS_ASYNC_BUSY = 1,          // Job (search, conversion or EEPROM transfer) in progress
+    DS_ASYNC_READING = 2        // Scratch-pads being read (one device per tick)
+} DsAsyncState_t;
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/* Completion callback (runs in DS18B20_AsyncTick context, may queue new requests) */
+/* "result" holds devices found (search) or devices read (convert, read), 0 otherwise */
+typedef void (*DsAsyncCallback_t)(void *context, DsAsyncOp_t op, DsAsyncStatus_t status, uint32_t result);
+
+/** Queued request (buffers and handles must stay valid until callback) **/
+typedef struct {
+    DsAsyncOp_t         op;
+    DsDevice_t          *device;    // Search: device buffer
+    float               *dataBuff;  // Convert, read
+    uint32_t            deviceCount;
+    DsConfig_t          dsConfig;   // Config
+    bool                isMultiMode; // Config, save, recall
+    DsAsyncCallback_t   callback;   // Optional
+    void                *context;
+} DsAsyncReq_t;
+
+/** Request queue of a bus (owned by caller, bus accessed by queue only) **/
+typedef struct {
+    DsBus_t             *bus;
+    DsAsyncReq_t        queue[DS_ASYNC_QUEUE_SIZE];
+    volatile uint8_t    headIdx;
+    volatile uint8_t    reqCount;
+    DsAsyncState_t      state;
+    DsConvJob_t         convJob;
+    DsSearchJob_t       searchJob;
+    DsRomJob_t          romJob;
+    uint32_t            pollTicks;  // DS_ASYNC_POLL_US in core timer ticks
+    uint32_t            pollTick;   // Next conversion or EEPROM transfer poll
+    uint32_t            readIdx;    // Next device to read
+    uint32_t            validCount; // Devices read
+} DsAsync_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool DS18B20_AsyncInit(DsAsync_t *async, DsBus_t *bus);
+bool DS18B20_AsyncSearch(DsAsync_t *async, DsDevice_t *deviceBuff, DsAsyncCallback_t callback, void *context);
+bool DS18B20_AsyncSearchAlarm(DsAsync_t *async, DsDevice_t *deviceBuff, DsAsyncCallback_t callback, void *context);
+bool DS18B20_AsyncConvert(DsAsync_t *async, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount, DsAsyncCallback_t callback, void *context);
+bool DS18B20_AsyncRead(DsAsync_t *async, DsDevice_t *device, float *dataBuff, const uint32_t deviceCount, DsAsyncCallback_t callback, void *context);
+bool DS18B20_AsyncConfig(DsAsync_t *async, DsConfig_t dsConfig, bool isMultiMode, DsAsyncCallback_t callback, void *context);
+bool DS18B20_AsyncSave(DsAsync_t *async, DsDevice_t *device, bool isMultiMode, DsAsyncCallback_t callback, void *context);
+bool DS18B20_AsyncRecall(DsAsync_t *async, DsDevice_t *device, bool isMultiMode, DsAsyncCallback_t callback, void *context);
+bool DS18B20_AsyncIsBusy(const DsAsync_t *async);
+void DS18B20_AsyncTick(DsAsync_t *async);
+
+#endif	/* DS18B20ASYNC_H */
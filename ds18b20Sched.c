@@ -0,0 +1,396 @@
+#include "ds18b20Sched.h"
+
+/*
+ *  Cooperative fixed-rate DS18B20 acquisition
+ *
+ *  Each group is a set of devices of one bus sampled with one conversion
+ *  (SKIP ROM for several devices) at a fixed period. Planned start times
+ *  advance by whole periods, so late starts don't accumulate drift. Every
+ *  DS18B20_SchedTick() call first starts the due conversions, then polls
+ *  converting groups (at most every DS_SCHED_POLL_US), then reads up to
+ *  DS_SCHED_READS_PER_TICK scratch-pads of the group with the earliest
+ *  deadline. One group samples a bus at a time, others wait for it.
+ *  DS18B20_SchedStart() spreads the first samples of the groups over their
+ *  periods, so the scratch-pad reads of one bus fit into the conversion time
+ *  of the others.
+ */
+
+/** SYSCLK assumed if scheduler was set up without it **/
+#define DEFAULT_SYSFREQ         8000000
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void StartSample(DsSched_t *sched, DsSchedGroup_t *group);
+static void PollSample(DsSched_t *sched, DsSchedGroup_t *group);
+static void ReadSample(DsSched_t *sched, DsSchedGroup_t *group);
+static void FinishSample(DsSched_t *sched, DsSchedGroup_t *group, bool isOk);
+static DsSchedGroup_t *GetReadGroup(DsSched_t *sched);
+static bool IsBusTaken(DsSched_t *sched, const DsSchedGroup_t *group);
+static uint32_t UsToTicks(const DsSched_t *sched, uint32_t timeUs);
+static uint32_t TicksToUs(const DsSched_t *sched, uint32_t coreTicks);
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Set up empty scheduler
+ */
+extern void DS18B20_SchedInit(DsSched_t *sched)
+{
+    sched->groupList = NULL;
+    sched->sysFreq = OSC_GetSysFreq();
+
+    /* SYSCLK default value */
+    if (sched->sysFreq == 0)
+    {
+        sched->sysFreq = DEFAULT_SYSFREQ;
+    }
+}
+
+
+/*
+ *  Add group of devices sampled every "periodMs" (first sample due at once,
+ *  groups added earlier start first when due together)
+ */
+extern bool DS18B20_SchedAddGroup(DsSched_t *sched, DsSchedGroup_t *group, DsSchedConfig_t schedConfig)
+{
+    /* Inputs check */
+    if ((sched == NULL) || (group == NULL) || (schedConfig.bus == NULL) || (schedConfig.device == NULL) ||
+        (schedConfig.dataBuff == NULL) || (schedConfig.deviceCount == 0) || (schedConfig.periodMs == 0))
+    {
+        return false;
+    }
+
+    /* Core timer differences within a period must stay signed (limit set by SYSCLK) */
+    uint64_t periodTicks = ((uint64_t)schedConfig.periodMs * sched->sysFreq) / 2000;
+    if (periodTicks > INT32_MAX)
+    {
+        return false;
+    }
+
+    /* Already scheduled check */
+    DsSchedGroup_t **link = &sched->groupList;
+    while (*link != NULL)
+    {
+        if (*link == group)
+        {
+            return false;
+        }
+        link = &(*link)->next;
+    }
+
+    group->config = schedConfig;
+    group->state = DS_SCHED_WAIT;
+    group->periodTicks = (uint32_t)periodTicks;
+    group->dueTick = _CP0_GET_COUNT();
+    group->next = NULL;
+    DS18B20_SchedResetStats(group);
+
+    *link = group;
+
+    return true;
+}
+
+
+/*
+ *  Remove group from scheduler (sample in progress abandoned)
+ */
+extern bool DS18B20_SchedRemoveGroup(DsSched_t *sched, DsSchedGroup_t *group)
+{
+    for (DsSchedGroup_t **link = &sched->groupList; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == group)
+        {
+            *link = group->next;
+
+            /* End strong pull-up of parasite conversion */
+            if ((group->state == DS_SCHED_CONV) && group->config.bus->isParasite)
+            {
+                OW_SetPullup(&group->config.bus->owBus, false);
+            }
+            group->state = DS_SCHED_WAIT;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ *  Plan first samples of all groups, spread evenly over their periods in the
+ *  order added (conversions of one bus overlap reads of another)
+ */
+extern void DS18B20_SchedStart(DsSched_t *sched)
+{
+    uint32_t nowTick = _CP0_GET_COUNT();
+    uint32_t groupCount = 0, groupIdx = 0;
+
+    for (DsSchedGroup_t *group = sched->groupList; group != NULL; group = group->next)
+    {
+        groupCount++;
+    }
+
+    for (DsSchedGroup_t *group = sched->groupList; group != NULL; group = group->next)
+    {
+        group->dueTick = nowTick + (uint32_t)(((uint64_t)group->periodTicks * groupIdx++) / groupCount);
+    }
+}
+
+
+/*
+ *  Run due work of all groups (call from main loop or periodic tick)
+ */
+extern void DS18B20_SchedTick(DsSched_t *sched)
+{
+    DsSchedGroup_t *group;
+
+    /* Starts first (lowest jitter), then conversion done polls */
+    for (group = sched->groupList; group != NULL; group = group->next)
+    {
+        if (group->state == DS_SCHED_WAIT)
+        {
+            StartSample(sched, group);
+        }
+        else if (group->state == DS_SCHED_CONV)
+        {
+            PollSample(sched, group);
+        }
+    }
+
+    /* Scratch-pad reads, earliest deadline first */
+    for (uint8_t readCount = 0; readCount < DS_SCHED_READS_PER_TICK; readCount++)
+    {
+        group = GetReadGroup(sched);
+        if (group == NULL)
+        {
+            break;
+        }
+
+        ReadSample(sched, group);
+    }
+}
+
+
+/*
+ *  Copy timing counters of a group
+ */
+extern void DS18B20_SchedGetStats(const DsSchedGroup_t *group, DsSchedStats_t *stats)
+{
+    *stats = group->stats;
+}
+
+
+/*
+ *  Clear timing counters of a group (period measured from next start)
+ */
+extern void DS18B20_SchedResetStats(DsSchedGroup_t *group)
+{
+    group->stats = (DsSchedStats_t){.minPeriodUs = UINT32_MAX};
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Start conversion of a due group once its bus is free, periods passed
+ *  entirely are counted as missed and skipped
+ */
+static void StartSample(DsSched_t *sched, DsSchedGroup_t *group)
+{
+    DsSchedConfig_t *config = &group->config;
+    DsSchedStats_t *stats = &group->stats;
+    uint32_t nowTick = _CP0_GET_COUNT();
+    int32_t lateTicks = (int32_t)(nowTick - group->dueTick);
+
+    /* Not due yet or bus sampled by another group */
+    if ((lateTicks < 0) || IsBusTaken(sched, group))
+    {
+        return;
+    }
+
+    if ((uint32_t)lateTicks >= group->periodTicks)
+    {
+        uint32_t skipCount = (uint32_t)lateTicks / group->periodTicks;
+
+        stats->missCount += skipCount;
+        group->dueTick += skipCount * group->periodTicks;
+        lateTicks -= skipCount * group->periodTicks;
+    }
+
+    /* Actual period (first start has none) and start jitter */
+    if (stats->startCount > 0)
+    {
+        uint32_t periodUs = TicksToUs(sched, nowTick - group->startTick);
+
+        stats->lastPeriodUs = periodUs;
+        stats->minPeriodUs = (periodUs < stats->minPeriodUs) ? periodUs : stats->minPeriodUs;
+        stats->maxPeriodUs = (periodUs > stats->maxPeriodUs) ? periodUs : stats->maxPeriodUs;
+        stats->periodSumUs += periodUs;
+    }
+
+    uint32_t jitterUs = TicksToUs(sched, lateTicks);
+    stats->maxJitterUs = (jitterUs > stats->maxJitterUs) ? jitterUs : stats->maxJitterUs;
+    stats->jitterSumUs += jitterUs;
+    stats->startCount++;
+    group->startTick = nowTick;
+    group->pollTick = nowTick + UsToTicks(sched, DS_SCHED_POLL_US);
+
+    if (DS18B20_StartConv(config->bus, &group->job, config->device, config->dataBuff, config->deviceCount))
+    {
+        group->state = DS_SCHED_CONV;
+    }
+    else
+    {
+        FinishSample(sched, group, false);
+    }
+}
+
+
+/*
+ *  Check conversion progress (parasite bus: no bus access, checked every call)
+ */
+static void PollSample(DsSched_t *sched, DsSchedGroup_t *group)
+{
+    uint32_t nowTick = _CP0_GET_COUNT();
+
+    if (!group->config.bus->isParasite && ((int32_t)(nowTick - group->pollTick) < 0))
+    {
+        return;
+    }
+    group->pollTick = nowTick + UsToTicks(sched, DS_SCHED_POLL_US);
+
+    switch (DS18B20_PollConv(&group->job))
+    {
+        case DS_CONV_BUSY:
+            break;
+
+        case DS_CONV_READY:
+            group->state = DS_SCHED_READ;
+            group->readIdx = 0;
+            group->isAllValid = true;
+            break;
+
+        default:
+            FinishSample(sched, group, false);
+            break;
+    }
+}
+
+
+/*
+ *  Read scratch-pad of next device of a group
+ */
+static void ReadSample(DsSched_t *sched, DsSchedGroup_t *group)
+{
+    DsSchedConfig_t *config = &group->config;
+    uint32_t idx = group->readIdx++;
+
+    group->isAllValid = DS18B20_ReadTemp(config->bus, &config->device[idx], &config->dataBuff[idx], 1) &&
+                        group->isAllValid;
+
+    if (group->readIdx >= config->deviceCount)
+    {
+        group->job.state = group->isAllValid ? DS_CONV_DONE : DS_CONV_ERROR;
+        FinishSample(sched, group, group->isAllValid);
+    }
+}
+
+
+/*
+ *  End sample, plan next one a period after the planned start of this one
+ */
+static void FinishSample(DsSched_t *sched, DsSchedGroup_t *group, bool isOk)
+{
+    DsSchedStats_t *stats = &group->stats;
+    uint32_t latencyTicks = _CP0_GET_COUNT() - group->dueTick;
+    uint32_t latencyUs = TicksToUs(sched, latencyTicks);
+
+    /* Not done before next planned start */
+    if (latencyTicks > group->periodTicks)
+    {
+        stats->missCount++;
+    }
+
+    if (isOk)
+    {
+        stats->sampleCount++;
+    }
+    else
+    {
+        stats->errorCount++;
+    }
+
+    stats->maxLatencyUs = (latencyUs > stats->maxLatencyUs) ? latencyUs : stats->maxLatencyUs;
+    group->dueTick += group->periodTicks;
+    group->state = DS_SCHED_WAIT;
+
+    if (group->config.sampleHook != NULL)
+    {
+        group->config.sampleHook(group->config.context, group, isOk);
+    }
+}
+
+
+/*
+ *  Find reading group with earliest deadline (planned start + period)
+ */
+static DsSchedGroup_t *GetReadGroup(DsSched_t *sched)
+{
+    DsSchedGroup_t *readGroup = NULL;
+    uint32_t nowTick = _CP0_GET_COUNT();
+    int32_t minLeftTicks = INT32_MAX;
+
+    for (DsSchedGroup_t *group = sched->groupList; group != NULL; group = group->next)
+    {
+        int32_t leftTicks = (int32_t)(group->dueTick + group->periodTicks - nowTick);
+
+        if ((group->state == DS_SCHED_READ) && ((readGroup == NULL) || (leftTicks < minLeftTicks)))
+        {
+            readGroup = group;
+            minLeftTicks = leftTicks;
+        }
+    }
+
+    return readGroup;
+}
+
+
+/*
+ *  Check if another group of the same bus is sampling
+ */
+static bool IsBusTaken(DsSched_t *sched, const DsSchedGroup_t *group)
+{
+    for (DsSchedGroup_t *other = sched->groupList; other != NULL; other = other->next)
+    {
+        if ((other != group) && (other->config.bus == group->config.bus) && (other->state != DS_SCHED_WAIT))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ *  Microseconds to core timer ticks (SYSCLK/2)
+ */
+static uint32_t UsToTicks(const DsSched_t *sched, uint32_t timeUs)
+{
+    return (uint32_t)(((uint64_t)timeUs * sched->sysFreq) / 2000000);
+}
+
+
+/*
+ *  Core timer ticks (SYSCLK/2) to microseconds
+ */
+static uint32_t TicksToUs(const DsSched_t *sched, uint32_t coreTicks)
+{
+    return (uint32_t)(((uint64_t)coreTicks * 2000000) / sched->sysFreq);
+}
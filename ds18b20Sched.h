@@ -0,0 +1,104 @@
+#ifndef DS18B20SCHED_H
+#define	DS18B20SCHED_H
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Custom libs **/
+#include "ds18b20.h"
+
+/******************************************************************************/
+/*---------------------------------Macros-------------------------------------*/
+/******************************************************************************/
+
+/** Conversion done bit polled at most once per interval (bus occupancy) **/
+#ifndef DS_SCHED_POLL_US
+#define DS_SCHED_POLL_US            5000
+#endif
+
+/** Scratch-pad reads per DS18B20_SchedTick call (bounds tick duration) **/
+#ifndef DS_SCHED_READS_PER_TICK
+#define DS_SCHED_READS_PER_TICK     1
+#endif
+
+/******************************************************************************/
+/*----------------------------Enumeration Types-------------------------------*/
+/******************************************************************************/
+
+/** Sampling state of a group **/
+typedef enum {
+    DS_SCHED_WAIT = 0,      // Waiting for planned start of next sample
+    DS_SCHED_CONV = 1,      // Conversion in progress
+    DS_SCHED_READ = 2       // Scratch-pads being read (one device per read)
+} DsSchedState_t;
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+typedef struct DsSchedGroup DsSchedGroup_t;
+
+/* Sample done callback (runs in DS18B20_SchedTick, "isOk" - all devices read) */
+typedef void (*DsSchedHook_t)(void *context, DsSchedGroup_t *group, bool isOk);
+
+/** Timing counters of a group (accumulated since start or last reset) **/
+typedef struct {
+    uint32_t        startCount;     // Conversions started
+    uint32_t        sampleCount;    // Samples with all devices read
+    uint32_t        errorCount;     // Samples failed (timeout, bus or CRC failure)
+    uint32_t        missCount;      // Samples not done within their period, periods skipped
+    uint32_t        lastPeriodUs;   // Between last two conversion starts
+    uint32_t        minPeriodUs;
+    uint32_t        maxPeriodUs;
+    uint64_t        periodSumUs;    // Mean period = periodSumUs / (startCount - 1)
+    uint32_t        maxJitterUs;    // Latest start after planned time
+    uint64_t        jitterSumUs;    // Mean jitter = jitterSumUs / startCount
+    uint32_t        maxLatencyUs;   // Longest planned start to sample done
+} DsSchedStats_t;
+
+/** Group parameters (devices of one bus sampled together) **/
+typedef struct {
+    DsBus_t         *bus;
+    DsDevice_t      *device;
+    float           *dataBuff;      // Sample of each device (kept if read fails)
+    uint32_t        deviceCount;
+    uint32_t        periodMs;       // Target sample period (max. 2^31 core timer ticks, 107 s at 40 MHz SYSCLK)
+    DsSchedHook_t   sampleHook;     // Optional
+    void            *context;       // Passed to sample hook
+} DsSchedConfig_t;
+
+/** Group of devices sampled at fixed rate (owned by caller while scheduled) **/
+struct DsSchedGroup {
+    DsSchedConfig_t config;
+    DsConvJob_t     job;
+    DsSchedState_t  state;
+    uint32_t        periodTicks;    // Core timer ticks
+    uint32_t        dueTick;        // Planned start of current (or next) sample
+    uint32_t        startTick;      // Actual start of current sample
+    uint32_t        pollTick;       // Next conversion done poll
+    uint32_t        readIdx;        // Next device to read
+    bool            isAllValid;
+    DsSchedStats_t  stats;
+    DsSchedGroup_t  *next;
+};
+
+/** Cooperative scheduler (owned by caller) **/
+typedef struct {
+    DsSchedGroup_t  *groupList;
+    uint32_t        sysFreq;        // Core timer timebase
+} DsSched_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+void DS18B20_SchedInit(DsSched_t *sched);
+bool DS18B20_SchedAddGroup(DsSched_t *sched, DsSchedGroup_t *group, DsSchedConfig_t schedConfig);
+bool DS18B20_SchedRemoveGroup(DsSched_t *sched, DsSchedGroup_t *group);
+void DS18B20_SchedStart(DsSched_t *sched);
+void DS18B20_SchedTick(DsSched_t *sched);
+void DS18B20_SchedGetStats(const DsSchedGroup_t *group, DsSchedStats_t *stats);
+void DS18B20_SchedResetStats(DsSchedGroup_t *group);
+
+#endif	/* DS18B20SCHED_H */
@@ -2,7 +2,7 @@
 #define TMR_DELAY_SYSCLK 40000000
 
 /** Custom libs **/
-#include "DS18B20.h"
+#include "ds18b20.h"
 
 int main (int argc, char** argv)
 {
@@ -16,26 +16,36 @@ int main (int argc, char** argv)
         .speedMode = OW_STANDARD_SPEED
     };
     
+    /* Bus context (one per bus) */
+    DsBus_t dsBus;
+    DS18B20_InitBus(&dsBus, owConfigBus);
+    
+    /* Compensate slot delays for GPIO/timer call overhead */
+    OW_CalibrateTiming(&dsBus.owBus);
+    
     /* Configuration structure for multiple devices */
     DsConfig_t dsConfig = {
         .measRes = DS_MEAS_RES_12BIT,
-        .owConfig = owConfigBus,
         .highAlarm = 40,
         .lowAlarm = 24
     };
     
     /* Identify all DS18B20 devices */
-    uint64_t romId[10] = {0};
+    DsDevice_t device[10] = {0};
     uint32_t deviceCount;
-    deviceCount = DS18B20_SearchDeviceId(owConfigBus.pinCode, romId);
+    deviceCount = DS18B20_SearchDeviceId(&dsBus, device);
     
     /* Check if any are fake - have fixed conversion time */
-    for (uint8_t idx = 0; idx < deviceCount; idx++)
+    bool isFake[10];
+    if (DS18B20_FindFakeDevices(&dsBus, device, isFake, deviceCount))
     {
-        if (DS18B20_IsDeviceFake(&romId[idx]))
+        for (uint8_t idx = 0; idx < deviceCount; idx++)
         {
-            dsConfig.measRes = DS_MEAS_RES_12BIT;
-            break;
+            if (isFake[idx])
+            {
+                dsConfig.measRes = DS_MEAS_RES_12BIT;
+                break;
+            }
         }
     }
     
@@ -45,23 +55,26 @@ int main (int argc, char** argv)
     
     float data[deviceCount];
     
-    /* Configure device */
-    if (DS18B20_ConfigDevice(dsConfig, isMultiMode))
+    /* Load known settings (unchanged devices are not written again) */
+    DS18B20_LoadConfig(&dsBus, device, deviceCount);
+    dsConfig.device = device;
+    dsConfig.deviceCount = deviceCount;
+    
+    /* Configure device and store alarm settings */
+    dsConfig.isSaved = true;
+    if (DS18B20_ConfigDevice(&dsBus, dsConfig, isMultiMode))
     {
-        /* Store alarm settings */
-        DS18B20_SaveToRom(romId, isMultiMode);
-        
         /* Start temperature conversion with internal timeout */
-        DS18B20_ConvertTemp(romId, deviceCount);
+        DS18B20_ConvertTemp(&dsBus, device, deviceCount);
         
         /* Wait for timeout */
-        while (!DS18B20_IsConvDone())
+        while (!DS18B20_IsConvDone(&dsBus))
         {
             PIO_TogglePin(GPIO_RPB4);
         }
         
         /* Store results */
-        DS18B20_ReadTemp(romId, data, deviceCount);
+        DS18B20_ReadTemp(&dsBus, device, data, deviceCount);
     }
     else
     {
@@ -69,37 +82,38 @@ int main (int argc, char** argv)
     }
     
     /* Do alarm flag search */
-    uint64_t alarmRomId[10];
+    DsDevice_t alarmDevice[10];
     uint32_t alarmCount;
-    alarmCount = DS18B20_SearchAlarm(owConfigBus.pinCode, alarmRomId);
+    alarmCount = DS18B20_SearchAlarm(&dsBus, alarmDevice);
     
     /* Devices at 25-40°C won't have their alarm flags set */
     
     /* Reconfigure to another alarm setting */
     dsConfig.lowAlarm = 0;
     dsConfig.highAlarm = 15;
-    DS18B20_ConfigDevice(dsConfig, isMultiMode);
+    dsConfig.isSaved = false;
+    DS18B20_ConfigDevice(&dsBus, dsConfig, isMultiMode);
 
     /* Do another conversion */
-    DS18B20_ConvertReadTemp(romId, data, deviceCount);
+    DS18B20_ConvertReadTemp(&dsBus, device, data, deviceCount);
 
     /* Do another alarm search */
-    alarmCount = DS18B20_SearchAlarm(owConfigBus.pinCode, alarmRomId);
+    alarmCount = DS18B20_SearchAlarm(&dsBus, alarmDevice);
     
     /* Alarm should be now triggered for devices above 15°C */
     
     /* Restore alarm settings */
-    DS18B20_CopyFromRom(romId, isMultiMode);
+    DS18B20_CopyFromRom(&dsBus, device, isMultiMode);
     
     /* Check one of devices' EEPROM if successfully copied */
     int ramData[3];
-    DS18B20_ReadRam(romId, ramData, 1);
+    DS18B20_ReadRam(&dsBus, device, ramData, 1);
     
     /* Do third conversion */
-    DS18B20_ConvertReadTemp(romId, data, deviceCount);
+    DS18B20_ConvertReadTemp(&dsBus, device, data, deviceCount);
 
     /* Do third alarm search */
-    alarmCount = DS18B20_SearchAlarm(owConfigBus.pinCode, alarmRomId);
+    alarmCount = DS18B20_SearchAlarm(&dsBus, alarmDevice);
     
     /* This time devices at 25-40°C won't have their alarm flags set */
 
@@ -0,0 +1,24 @@
+#ifndef IC_H
+#define	IC_H
+
+/*
+ *  Host stand-in for the PIC32MX interrupt controller library (simulated)
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+uint32_t IC_GetInterruptState(void);
+void IC_SetInterruptState(uint32_t intrState);
+void IC_DisableInterrupts(void);
+void IC_EnableInterrupts(void);
+
+#endif	/* IC_H */
@@ -0,0 +1,21 @@
+#ifndef OSC_H
+#define	OSC_H
+
+/*
+ *  Host stand-in for the PIC32MX oscillator library (simulated)
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+uint32_t OSC_GetSysFreq(void);
+
+#endif	/* OSC_H */
@@ -0,0 +1,1269 @@
+#include <string.h>
+#include <math.h>
+
+#include "OwSim.h"
+
+/** Simulated device family code **/
+#define SIM_FAMILY_CODE         0x28
+
+/** Simulated device timing (worst case datasheet values) **/
+#define SIM_CONV_9BIT_NS        93750000ULL     // Doubles per resolution bit
+#define SIM_COPY_MEM_NS         10000000ULL
+#define SIM_RECALL_EEPROM_NS    10000ULL
+#define SIM_PULLUP_DELAY_NS     10000ULL        // Parasite: strong pull-up within tSPON after release of last slot
+
+/** Power-on scratch-pad and EEPROM values **/
+#define SIM_POWER_ON_TEMP       0x0550          // +85 degC
+#define SIM_DEFAULT_HI_ALARM    0x4B
+#define SIM_DEFAULT_LO_ALARM    0x46
+#define SIM_DEFAULT_CONFIG      0x7F
+
+/******************************************************************************/
+/*--------------------------Local Data Structures-----------------------------*/
+/******************************************************************************/
+
+/** Device protocol states **/
+typedef enum {
+    DEV_IDLE,
+    DEV_ROM_CMD,
+    DEV_MATCH_ROM,
+    DEV_SEARCH_ROM,
+    DEV_READ_ROM,
+    DEV_FUNC_CMD,
+    DEV_WRITE_MEM,
+    DEV_READ_MEM,
+    DEV_BUSY_POLL,
+    DEV_READ_POWER
+} DevState_t;
+
+/** Device-side slot timing per speed mode **/
+typedef struct {
+    uint64_t    resetMinNs;     // Shortest LOW pulse recognized as reset
+    uint64_t    sampleNs;       // Write slot sample point after falling edge
+    uint64_t    holdNs;         // LOW hold time when transmitting zero
+    uint64_t    presenceWaitNs; // tPDH
+    uint64_t    presenceNs;     // tPDL
+} SlotTiming_t;
+
+static const SlotTiming_t slotTiming[] = {
+    [OW_STANDARD_SPEED] = {300000, 15000, 30000, 30000, 120000},
+    [OW_HIGH_SPEED]     = {200000, 15000, 25000, 30000, 120000},
+    [OW_OVERLOAD_SPEED] = { 48000,  4000,  6000,  2000,  10000}
+};
+
+/** Virtual DS18B20 **/
+typedef struct {
+    uint64_t    rom;                // Family code, serial and CRC
+    uint8_t     scratchpad[9];
+    uint8_t     eeprom[3];
+    float       temp;
+    bool        isFake;             // Fixed 12-bit conversion time
+    bool        isParasite;         // Powered from data line (needs strong pull-up)
+    bool        isPowered;          // Parasite: strong pull-up held since command
+    bool        isCopyPending;      // Parasite: EEPROM written when copy time elapsed
+    bool        isAlarm;
+    bool        isConvPending;
+    uint32_t    readErrorCount;     // Scratch-pad reads still to corrupt
+    bool        isReadCorrupt;      // Current scratch-pad read corrupted
+    bool        isDetached;         // Ignores resets (bus reads all ones)
+    uint64_t    busyUntilNs;
+    uint64_t    pullFromNs;         // Device drives bus LOW in this window
+    uint64_t    pullUntilNs;
+    DevState_t  state;
+    uint16_t    bitIdx;
+    uint8_t     searchPhase;        // Bit, complement, master's choice
+    uint32_t    rxData;
+} SimDevice_t;
+
+/** Virtual bus **/
+typedef struct {
+    uint32_t        pinCode;
+    OwSpeedMode_t   speedMode;
+    bool            isMasterLow;
+    uint64_t        lowStartNs;
+    uint32_t        pullupPinCode;  // Strong pull-up switch (0 - bus pin driven HIGH only)
+    bool            isPullupActiveLow;
+    bool            isPullupOn;
+    uint64_t        releaseNs;      // Master released last slot
+    uint32_t        deviceCount;
+    uint16_t        deviceIdx[OWSIM_MAX_DEVICE_COUNT];
+} SimBus_t;
+
+/******************************************************************************/
+/*--------------------------Local Data Variables------------------------------*/
+/******************************************************************************/
+
+static struct {
+    uint32_t        sysFreq;
+    uint64_t        nowNs;
+    OwSimCost_t     cost;
+    OwSimStats_t    stats;
+    uint64_t        maskStartNs;
+    uint32_t        intrState;      // 1 - interrupts enabled
+    uint32_t        lat[PIO_PORT_COUNT];
+    uint32_t        tris[PIO_PORT_COUNT];   // 1 - input
+    uint32_t        busCount;
+    uint32_t        deviceCount;
+    OwSimIsr_t      timerIsr;
+    uint64_t        timerDueNs;
+    bool            isTimerArmed;
+    bool            isInIsr;
+    uint32_t        uartPinCode;
+    uint32_t        uartBaud;
+} simVar = {
+    .sysFreq = OWSIM_DEFAULT_SYSFREQ,
+    .cost = {.counterNs = 100},
+    .intrState = 1,
+    .tris = {0xFFFF, 0xFFFF, 0xFFFF}
+};
+
+static SimBus_t simBus[OWSIM_MAX_BUS_COUNT];
+static SimDevice_t simDevice[OWSIM_MAX_DEVICE_COUNT];
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void AdvanceNs(uint64_t delayNs, bool isBusy);
+static void AdvanceToNs(uint64_t timeNs, bool isBusy);
+static void UartCost(void);
+static void AddTime(uint64_t delayNs, bool isBusy);
+static SimBus_t *FindBus(const uint32_t pinCode);
+static void UpdatePort(uint32_t port);
+static void UpdatePullup(SimBus_t *bus);
+static void BusFallingEdge(SimBus_t *bus);
+static void BusRisingEdge(SimBus_t *bus);
+static uint8_t BusLevel(SimBus_t *bus);
+
+static void DeviceSync(SimDevice_t *dev);
+static void DevicePowerLoss(SimDevice_t *dev);
+static void DeviceEnterState(SimDevice_t *dev, DevState_t state);
+static int8_t DeviceTxBit(SimDevice_t *dev);
+static void DeviceSlotEnd(SimDevice_t *dev, uint8_t dataBit);
+static void DeviceRomCommand(SimDevice_t *dev, uint8_t cmd);
+static void DeviceFuncCommand(SimDevice_t *dev, uint8_t cmd);
+static void DeviceUpdateCrc(SimDevice_t *dev);
+static uint8_t Crc8(const uint8_t *dataPtr, uint32_t dataLen);
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Reset simulator to power-on state (no buses, no devices, time zero)
+ */
+extern void OWSIM_Init(uint32_t sysFreq)
+{
+    memset(&simVar, 0, sizeof(simVar));
+    simVar.sysFreq = (sysFreq != 0) ? sysFreq : OWSIM_DEFAULT_SYSFREQ;
+    simVar.cost.counterNs = 100;
+    simVar.intrState = 1;
+
+    for (uint32_t port = 0; port < PIO_PORT_COUNT; port++)
+    {
+        simVar.tris[port] = 0xFFFF;
+    }
+}
+
+
+/*
+ *  Set CPU cost of HAL stand-in calls
+ */
+extern void OWSIM_SetCost(OwSimCost_t cost)
+{
+    simVar.cost = cost;
+}
+
+
+/*
+ *  Advance simulated time while CPU does other (non-bus) work
+ */
+extern void OWSIM_AdvanceUs(uint32_t delayUs)
+{
+    AdvanceNs((uint64_t)delayUs * 1000, false);
+}
+
+
+/*
+ *  Get simulated time since initialization
+ */
+extern uint64_t OWSIM_GetTimeNs(void)
+{
+    return simVar.nowNs;
+}
+
+
+/*
+ *  Copy accumulated counters (closes currently open masked window)
+ */
+extern void OWSIM_GetStats(OwSimStats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    *stats = simVar.stats;
+
+    if (simVar.intrState == 0)
+    {
+        uint64_t maskedNs = simVar.nowNs - simVar.maskStartNs;
+        stats->maskedNs += maskedNs;
+        stats->maxMaskedNs = (maskedNs > stats->maxMaskedNs) ? maskedNs : stats->maxMaskedNs;
+    }
+}
+
+
+/*
+ *  Clear accumulated counters
+ */
+extern void OWSIM_ResetStats(void)
+{
+    memset(&simVar.stats, 0, sizeof(simVar.stats));
+    simVar.maskStartNs = simVar.nowNs;
+}
+
+
+/*
+ *  Register handler of simulated timer interrupt
+ */
+extern void OWSIM_SetTimerIsr(OwSimIsr_t timerIsr)
+{
+    simVar.timerIsr = timerIsr;
+}
+
+
+/*
+ *  (Re-)arm simulated timer relative to current time (0 stops timer)
+ */
+extern void OWSIM_ArmTimerUs(uint32_t delayUs)
+{
+    simVar.isTimerArmed = (delayUs > 0);
+    simVar.timerDueNs = simVar.nowNs + (uint64_t)delayUs * 1000;
+}
+
+
+/*
+ *  Route UART TX (open-drain) and RX to bus pin, line idles HIGH
+ */
+extern bool OWSIM_AttachUart(const uint32_t pinCode)
+{
+    uint32_t port = PIO_PIN_PORT(pinCode);
+
+    if ((port >= PIO_PORT_COUNT) || (PIO_PIN_MASK(pinCode) == 0))
+    {
+        return false;
+    }
+
+    simVar.uartPinCode = pinCode;
+    simVar.lat[port] &= ~PIO_PIN_MASK(pinCode);
+    simVar.tris[port] |= PIO_PIN_MASK(pinCode);
+    UpdatePort(port);
+
+    return true;
+}
+
+
+/*
+ *  Set UART baud rate (OwUartSetBaud_t hook)
+ */
+extern void OWSIM_UartSetBaud(uint32_t baudRate)
+{
+    UartCost();
+    simVar.uartBaud = baudRate;
+}
+
+
+/*
+ *  Send 8N1 frames back to back on bus pin and sample RX at bit centers
+ *  (OwUartExchange_t hook, CPU only pays set-up - frames run on UART time)
+ */
+extern void OWSIM_UartExchange(const uint8_t *txData, uint8_t *rxData, uint16_t dataLen)
+{
+    uint32_t port = PIO_PIN_PORT(simVar.uartPinCode);
+    uint32_t pinMask = PIO_PIN_MASK(simVar.uartPinCode);
+    SimBus_t *bus = FindBus(simVar.uartPinCode);
+
+    if ((pinMask == 0) || (simVar.uartBaud == 0) || (txData == NULL) || (rxData == NULL))
+    {
+        return;
+    }
+
+    UartCost();
+
+    for (uint16_t byteIdx = 0; byteIdx < dataLen; byteIdx++)
+    {
+        uint16_t frame = 0x200 | ((uint16_t)txData[byteIdx] << 1);     // Start bit, LSB first, stop bit
+        uint64_t frameStartNs = simVar.nowNs;
+        uint8_t rxByte = 0;
+
+        for (uint8_t bitIdx = 0; bitIdx < 10; bitIdx++)
+        {
+            /* Open-drain TX: LOW bits drive the line, HIGH bits release it */
+            simVar.tris[port] = ((frame >> bitIdx) & 0x01) ? (simVar.tris[port] | pinMask) : (simVar.tris[port] & ~pinMask);
+            UpdatePort(port);
+
+            AdvanceToNs(frameStartNs + (1000000000ULL * (2 * bitIdx + 1)) / (2 * simVar.uartBaud), true);
+            if ((bitIdx >= 1) && (bitIdx <= 8))
+            {
+                rxByte |= ((bus != NULL) ? BusLevel(bus) : 1) << (bitIdx - 1);
+            }
+            AdvanceToNs(frameStartNs + (1000000000ULL * (bitIdx + 1)) / simVar.uartBaud, true);
+        }
+
+        rxData[byteIdx] = rxByte;
+    }
+}
+
+
+/*
+ *  Attach virtual bus to a GPIO pin
+ */
+extern bool OWSIM_AddBus(const uint32_t pinCode, OwSpeedMode_t speedMode)
+{
+    if ((simVar.busCount >= OWSIM_MAX_BUS_COUNT) || (FindBus(pinCode) != NULL))
+    {
+        return false;
+    }
+
+    SimBus_t *bus = &simBus[simVar.busCount++];
+    memset(bus, 0, sizeof(*bus));
+    bus->pinCode = pinCode;
+    bus->speedMode = speedMode;
+
+    return true;
+}
+
+
+/*
+ *  Attach strong pull-up switch pin to bus (enabled when driven to active
+ *  level, bus pin driven HIGH always counts as strong pull-up)
+ */
+extern bool OWSIM_SetPullupPin(const uint32_t pinCode, const uint32_t pullupPinCode, bool isActiveLow)
+{
+    SimBus_t *bus = FindBus(pinCode);
+
+    if (bus == NULL)
+    {
+        return false;
+    }
+
+    bus->pullupPinCode = pullupPinCode;
+    bus->isPullupActiveLow = isActiveLow;
+    UpdatePullup(bus);
+
+    return true;
+}
+
+
+/*
+ *  Change device-side slot timing of all devices on bus
+ */
+extern void OWSIM_SetSpeedMode(const uint32_t pinCode, OwSpeedMode_t speedMode)
+{
+    SimBus_t *bus = FindBus(pinCode);
+
+    if (bus != NULL)
+    {
+        bus->speedMode = speedMode;
+    }
+}
+
+
+/*
+ *  Attach virtual DS18B20 with 48-bit serial "romId" (as used by the driver)
+ *  Returns device index or -1 if bus not found or capacity exceeded
+ */
+extern int32_t OWSIM_AddDevice(const uint32_t pinCode, uint64_t romId)
+{
+    SimBus_t *bus = FindBus(pinCode);
+
+    if ((bus == NULL) || (simVar.deviceCount >= OWSIM_MAX_DEVICE_COUNT))
+    {
+        return -1;
+    }
+
+    int32_t devIdx = simVar.deviceCount++;
+    SimDevice_t *dev = &simDevice[devIdx];
+    memset(dev, 0, sizeof(*dev));
+
+    /* Build ROM code (family code, serial, CRC) */
+    uint64_t rom = ((romId & 0xFFFFFFFFFFFF) << 8) | SIM_FAMILY_CODE;
+    uint8_t romBytes[8];
+    for (uint8_t idx = 0; idx < 8; idx++)
+    {
+        romBytes[idx] = (rom >> (idx * 8)) & 0xFF;
+    }
+    dev->rom = rom | ((uint64_t)Crc8(romBytes, 7) << 56);
+
+    /* Power-on state */
+    dev->eeprom[0] = SIM_DEFAULT_HI_ALARM;
+    dev->eeprom[1] = SIM_DEFAULT_LO_ALARM;
+    dev->eeprom[2] = SIM_DEFAULT_CONFIG;
+    dev->scratchpad[0] = SIM_POWER_ON_TEMP & 0xFF;
+    dev->scratchpad[1] = SIM_POWER_ON_TEMP >> 8;
+    memcpy(&dev->scratchpad[2], dev->eeprom, 3);
+    dev->scratchpad[5] = 0xFF;
+    dev->scratchpad[6] = 0x0C;
+    dev->scratchpad[7] = 0x10;
+    DeviceUpdateCrc(dev);
+    dev->temp = 25.0;
+    dev->state = DEV_IDLE;
+
+    bus->deviceIdx[bus->deviceCount++] = devIdx;
+
+    return devIdx;
+}
+
+
+/*
+ *  Set temperature sampled by next conversion
+ */
+extern void OWSIM_SetTemp(int32_t devIdx, float temp)
+{
+    if ((devIdx >= 0) && ((uint32_t)devIdx < simVar.deviceCount))
+    {
+        simDevice[devIdx].temp = temp;
+    }
+}
+
+
+/*
+ *  Mark device as clone with fixed (12-bit) conversion time
+ */
+extern void OWSIM_SetFake(int32_t devIdx, bool isFake)
+{
+    if ((devIdx >= 0) && ((uint32_t)devIdx < simVar.deviceCount))
+    {
+        simDevice[devIdx].isFake = isFake;
+    }
+}
+
+
+/*
+ *  Power device from data line - it reads as parasite powered and completes
+ *  conversion and EEPROM copy only if the strong pull-up is enabled within
+ *  10 us after the command's last slot and held (no slots) for the whole time
+ */
+extern void OWSIM_SetParasite(int32_t devIdx, bool isParasite)
+{
+    if ((devIdx >= 0) && ((uint32_t)devIdx < simVar.deviceCount))
+    {
+        simDevice[devIdx].isParasite = isParasite;
+    }
+}
+
+
+/*
+ *  Corrupt next "errorCount" scratch-pad reads of device (temperature LSB
+ *  sent with its lowest bit flipped, so the CRC fails)
+ */
+extern void OWSIM_SetReadErrors(int32_t devIdx, uint32_t errorCount)
+{
+    if ((devIdx >= 0) && ((uint32_t)devIdx < simVar.deviceCount))
+    {
+        simDevice[devIdx].readErrorCount = errorCount;
+    }
+}
+
+
+/*
+ *  Detach device from bus (no presence pulse and no response from next reset,
+ *  as a device that lost its connection while others still answer)
+ */
+extern void OWSIM_SetDetached(int32_t devIdx, bool isDetached)
+{
+    if ((devIdx >= 0) && ((uint32_t)devIdx < simVar.deviceCount))
+    {
+        simDevice[devIdx].isDetached = isDetached;
+    }
+}
+
+
+/*
+ *  Get 48-bit serial of device (as used by the driver)
+ */
+extern uint64_t OWSIM_GetRomId(int32_t devIdx)
+{
+    if ((devIdx < 0) || ((uint32_t)devIdx >= simVar.deviceCount))
+    {
+        return 0;
+    }
+
+    return (simDevice[devIdx].rom >> 8) & 0xFFFFFFFFFFFF;
+}
+
+
+/*
+ *  Copy 9 scratch-pad bytes of device
+ */
+extern void OWSIM_GetScratchpad(int32_t devIdx, uint8_t *dataBuff)
+{
+    if ((devIdx >= 0) && ((uint32_t)devIdx < simVar.deviceCount) && (dataBuff != NULL))
+    {
+        DeviceSync(&simDevice[devIdx]);
+        memcpy(dataBuff, simDevice[devIdx].scratchpad, 9);
+    }
+}
+
+
+/*
+ *  Copy 3 EEPROM bytes of device (TH, TL, configuration)
+ */
+extern void OWSIM_GetEeprom(int32_t devIdx, uint8_t *dataBuff)
+{
+    if ((devIdx >= 0) && ((uint32_t)devIdx < simVar.deviceCount) && (dataBuff != NULL))
+    {
+        DeviceSync(&simDevice[devIdx]);
+        memcpy(dataBuff, simDevice[devIdx].eeprom, 3);
+    }
+}
+
+
+/*
+ *  Get alarm flag of device (as evaluated by last conversion)
+ */
+extern bool OWSIM_IsAlarm(int32_t devIdx)
+{
+    if ((devIdx < 0) || ((uint32_t)devIdx >= simVar.deviceCount))
+    {
+        return false;
+    }
+
+    DeviceSync(&simDevice[devIdx]);
+    return simDevice[devIdx].isAlarm;
+}
+
+/******************************************************************************/
+/*----------------------HAL Stand-in Function Definitions---------------------*/
+/******************************************************************************/
+
+extern void PIO_ConfigGpioPin(const uint32_t pinCode, PioType_t pinType, PioDir_t pinDir)
+{
+    (void)pinType;
+    PIO_ConfigGpioPinDir(pinCode, pinDir);
+}
+
+
+extern void PIO_ConfigGpioPinDir(const uint32_t pinCode, PioDir_t pinDir)
+{
+    uint32_t port = PIO_PIN_PORT(pinCode);
+
+    AdvanceNs(simVar.cost.pioNs, true);
+    if (pinDir == PIO_DIR_INPUT)
+    {
+        simVar.tris[port] |= PIO_PIN_MASK(pinCode);
+    }
+    else
+    {
+        simVar.tris[port] &= ~PIO_PIN_MASK(pinCode);
+    }
+    UpdatePort(port);
+}
+
+
+extern void PIO_SetPin(const uint32_t pinCode)
+{
+    uint32_t port = PIO_PIN_PORT(pinCode);
+
+    AdvanceNs(simVar.cost.pioNs, true);
+    simVar.lat[port] |= PIO_PIN_MASK(pinCode);
+    UpdatePort(port);
+}
+
+
+extern void PIO_ClearPin(const uint32_t pinCode)
+{
+    uint32_t port = PIO_PIN_PORT(pinCode);
+
+    AdvanceNs(simVar.cost.pioNs, true);
+    simVar.lat[port] &= ~PIO_PIN_MASK(pinCode);
+    UpdatePort(port);
+}
+
+
+extern void PIO_TogglePin(const uint32_t pinCode)
+{
+    uint32_t port = PIO_PIN_PORT(pinCode);
+
+    AdvanceNs(simVar.cost.pioNs, false);
+    simVar.lat[port] ^= PIO_PIN_MASK(pinCode);
+    UpdatePort(port);
+}
+
+
+extern uint8_t PIO_ReadPin(const uint32_t pinCode)
+{
+    uint32_t port = PIO_PIN_PORT(pinCode);
+    SimBus_t *bus = FindBus(pinCode);
+
+    AdvanceNs(simVar.cost.pioNs, bus != NULL);
+
+    /* Bus pins read wired-AND level, other inputs are pulled up */
+    if (bus != NULL)
+    {
+        return BusLevel(bus);
+    }
+    if (simVar.tris[port] & PIO_PIN_MASK(pinCode))
+    {
+        return 1;
+    }
+
+    return (simVar.lat[port] & PIO_PIN_MASK(pinCode)) ? 1 : 0;
+}
+
+
+extern uint32_t PIO_ReadPort(const uint32_t pinCode)
+{
+    uint32_t port = PIO_PIN_PORT(pinCode);
+    uint32_t pinMask = PIO_PIN_MASK(pinCode);
+    uint32_t portVal = simVar.tris[port] | simVar.lat[port];
+
+    AdvanceNs(simVar.cost.pioNs, true);
+
+    /* Bus pins read wired-AND level, other inputs are pulled up */
+    for (uint32_t idx = 0; idx < simVar.busCount; idx++)
+    {
+        SimBus_t *bus = &simBus[idx];
+
+        if ((PIO_PIN_PORT(bus->pinCode) == port) && (PIO_PIN_MASK(bus->pinCode) & pinMask))
+        {
+            uint32_t busMask = PIO_PIN_MASK(bus->pinCode);
+
+            portVal = BusLevel(bus) ? (portVal | busMask) : (portVal & ~busMask);
+        }
+    }
+
+    return portVal & pinMask;
+}
+
+
+extern void TMR_DelayUs(uint32_t delayUs)
+{
+    AdvanceNs((uint64_t)delayUs * 1000 + simVar.cost.delayNs, true);
+}
+
+
+extern uint32_t IC_GetInterruptState(void)
+{
+    return simVar.intrState;
+}
+
+
+extern void IC_SetInterruptState(uint32_t intrState)
+{
+    (intrState != 0) ? IC_EnableInterrupts() : IC_DisableInterrupts();
+}
+
+
+extern void IC_DisableInterrupts(void)
+{
+    if (simVar.intrState != 0)
+    {
+        simVar.intrState = 0;
+        simVar.maskStartNs = simVar.nowNs;
+    }
+}
+
+
+extern void IC_EnableInterrupts(void)
+{
+    if (simVar.intrState == 0)
+    {
+        uint64_t maskedNs = simVar.nowNs - simVar.maskStartNs;
+
+        simVar.intrState = 1;
+        simVar.stats.maskedNs += maskedNs;
+        if (maskedNs > simVar.stats.maxMaskedNs)
+        {
+            simVar.stats.maxMaskedNs = maskedNs;
+        }
+    }
+}
+
+
+extern uint32_t OSC_GetSysFreq(void)
+{
+    return simVar.sysFreq;
+}
+
+
+/*
+ *  Core timer ticks at SYSCLK/2 (every read costs CPU time so polling ends)
+ */
+extern uint32_t _CP0_GET_COUNT(void)
+{
+    AdvanceNs(simVar.cost.counterNs, false);
+
+    return (uint32_t)((simVar.nowNs * (simVar.sysFreq / 2000)) / 1000000);
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Advance simulated clock (timer interrupt fires when due and enabled)
+ */
+static void AdvanceNs(uint64_t delayNs, bool isBusy)
+{
+    while (simVar.isTimerArmed && !simVar.isInIsr && (simVar.intrState != 0) &&
+           (simVar.timerIsr != NULL) && (simVar.timerDueNs <= simVar.nowNs + delayNs))
+    {
+        uint64_t stepNs = (simVar.timerDueNs > simVar.nowNs) ? (simVar.timerDueNs - simVar.nowNs) : 0;
+        uint64_t isrStartNs;
+
+        AddTime(stepNs, isBusy);
+        delayNs -= stepNs;
+
+        /* ISR may re-arm the timer */
+        simVar.isTimerArmed = false;
+        simVar.isInIsr = true;
+        simVar.stats.isrCount++;
+        isrStartNs = simVar.nowNs;
+        AddTime(simVar.cost.isrNs, false);
+        simVar.timerIsr();
+        simVar.stats.isrNs += simVar.nowNs - isrStartNs;
+        simVar.isInIsr = false;
+    }
+
+    AddTime(delayNs, isBusy);
+}
+
+
+/*
+ *  Advance simulated clock up to given time (no-op if already passed)
+ */
+static void AdvanceToNs(uint64_t timeNs, bool isBusy)
+{
+    if (timeNs > simVar.nowNs)
+    {
+        AdvanceNs(timeNs - simVar.nowNs, isBusy);
+    }
+}
+
+
+/*
+ *  CPU time of UART set-up (FIFO/DMA) per hook call
+ */
+static void UartCost(void)
+{
+    AdvanceNs(simVar.cost.uartNs, false);
+    simVar.stats.uartNs += simVar.cost.uartNs;
+}
+
+
+/*
+ *  Add time to simulated clock and counters
+ */
+static void AddTime(uint64_t delayNs, bool isBusy)
+{
+    simVar.nowNs += delayNs;
+    simVar.stats.timeNs += delayNs;
+
+    if (isBusy)
+    {
+        simVar.stats.busyNs += delayNs;
+    }
+}
+
+
+/*
+ *  Find bus attached to given pin
+ */
+static SimBus_t *FindBus(const uint32_t pinCode)
+{
+    for (uint32_t idx = 0; idx < simVar.busCount; idx++)
+    {
+        if (simBus[idx].pinCode == pinCode)
+        {
+            return &simBus[idx];
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ *  Propagate master-side pin changes of a port to attached buses
+ */
+static void UpdatePort(uint32_t port)
+{
+    for (uint32_t idx = 0; idx < simVar.busCount; idx++)
+    {
+        SimBus_t *bus = &simBus[idx];
+        uint32_t pinMask = PIO_PIN_MASK(bus->pinCode);
+
+        UpdatePullup(bus);
+
+        if (PIO_PIN_PORT(bus->pinCode) != port)
+        {
+            continue;
+        }
+
+        /* Open-drain emulation: LOW only when output and latch cleared */
+        bool isMasterLow = !(simVar.tris[port] & pinMask) && !(simVar.lat[port] & pinMask);
+
+        if (isMasterLow && !bus->isMasterLow)
+        {
+            BusFallingEdge(bus);
+        }
+        else if (!isMasterLow && bus->isMasterLow)
+        {
+            BusRisingEdge(bus);
+        }
+    }
+}
+
+
+/*
+ *  Track strong pull-up of bus (bus pin or switch pin driven to active
+ *  level), parasite devices lose power if it comes late or ends early
+ */
+static void UpdatePullup(SimBus_t *bus)
+{
+    uint32_t port = PIO_PIN_PORT(bus->pinCode);
+    uint32_t pinMask = PIO_PIN_MASK(bus->pinCode);
+    bool isPullupOn = !(simVar.tris[port] & pinMask) && ((simVar.lat[port] & pinMask) == pinMask);
+
+    if (bus->pullupPinCode != 0)
+    {
+        uint32_t swPort = PIO_PIN_PORT(bus->pullupPinCode);
+        uint32_t swMask = PIO_PIN_MASK(bus->pullupPinCode);
+        bool isHigh = (simVar.lat[swPort] & swMask) != 0;
+
+        isPullupOn = isPullupOn || (!(simVar.tris[swPort] & swMask) && (isHigh != bus->isPullupActiveLow));
+    }
+
+    if (isPullupOn == bus->isPullupOn)
+    {
+        return;
+    }
+    bus->isPullupOn = isPullupOn;
+
+    for (uint32_t idx = 0; idx < bus->deviceCount; idx++)
+    {
+        SimDevice_t *dev = &simDevice[bus->deviceIdx[idx]];
+
+        DeviceSync(dev);
+        if (isPullupOn)
+        {
+            dev->isPowered = (simVar.nowNs <= bus->releaseNs + SIM_PULLUP_DELAY_NS);
+        }
+        else
+        {
+            DevicePowerLoss(dev);
+        }
+    }
+}
+
+
+/*
+ *  Master starts a slot or reset pulse
+ */
+static void BusFallingEdge(SimBus_t *bus)
+{
+    const SlotTiming_t *timing = &slotTiming[bus->speedMode];
+
+    bus->isMasterLow = true;
+    bus->lowStartNs = simVar.nowNs;
+
+    /* Transmitting devices hold the line LOW to send zero */
+    for (uint32_t idx = 0; idx < bus->deviceCount; idx++)
+    {
+        SimDevice_t *dev = &simDevice[bus->deviceIdx[idx]];
+
+        DeviceSync(dev);
+        DevicePowerLoss(dev);
+        if (DeviceTxBit(dev) == 0)
+        {
+            dev->pullFromNs = simVar.nowNs;
+            dev->pullUntilNs = simVar.nowNs + timing->holdNs;
+        }
+    }
+}
+
+
+/*
+ *  Master releases the line (ends a slot or reset pulse)
+ */
+static void BusRisingEdge(SimBus_t *bus)
+{
+    const SlotTiming_t *timing = &slotTiming[bus->speedMode];
+    uint64_t lowNs = simVar.nowNs - bus->lowStartNs;
+
+    bus->isMasterLow = false;
+
+    /* Reset pulse: all devices answer with presence pulse */
+    if (lowNs >= timing->resetMinNs)
+    {
+        simVar.stats.resetCount++;
+
+        for (uint32_t idx = 0; idx < bus->deviceCount; idx++)
+        {
+            SimDevice_t *dev = &simDevice[bus->deviceIdx[idx]];
+
+            DeviceSync(dev);
+            if (dev->isDetached)
+            {
+                DeviceEnterState(dev, DEV_IDLE);
+                continue;
+            }
+            DeviceEnterState(dev, DEV_ROM_CMD);
+            dev->pullFromNs = simVar.nowNs + timing->presenceWaitNs;
+            dev->pullUntilNs = dev->pullFromNs + timing->presenceNs;
+        }
+        return;
+    }
+
+    /* Regular slot: short LOW pulse is a one */
+    simVar.stats.slotCount++;
+    bus->releaseNs = simVar.nowNs;
+    uint8_t dataBit = (lowNs < timing->sampleNs) ? 1 : 0;
+
+    for (uint32_t idx = 0; idx < bus->deviceCount; idx++)
+    {
+        DeviceSlotEnd(&simDevice[bus->deviceIdx[idx]], dataBit);
+    }
+}
+
+
+/*
+ *  Wired-AND bus level at current time
+ */
+static uint8_t BusLevel(SimBus_t *bus)
+{
+    if (bus->isMasterLow)
+    {
+        return 0;
+    }
+
+    for (uint32_t idx = 0; idx < bus->deviceCount; idx++)
+    {
+        SimDevice_t *dev = &simDevice[bus->deviceIdx[idx]];
+
+        if ((simVar.nowNs >= dev->pullFromNs) && (simVar.nowNs < dev->pullUntilNs))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/*
+ *  Complete pending conversion once its conversion time elapsed
+ */
+static void DeviceSync(SimDevice_t *dev)
+{
+    if ((!dev->isConvPending && !dev->isCopyPending) || (simVar.nowNs < dev->busyUntilNs))
+    {
+        return;
+    }
+
+    /* Parasite device without strong pull-up resets (power-on temperature) */
+    if (dev->isParasite && !dev->isPowered)
+    {
+        dev->isConvPending = false;
+        dev->isCopyPending = false;
+        dev->scratchpad[0] = SIM_POWER_ON_TEMP & 0xFF;
+        dev->scratchpad[1] = SIM_POWER_ON_TEMP >> 8;
+        DeviceUpdateCrc(dev);
+        return;
+    }
+
+    if (dev->isCopyPending)
+    {
+        dev->isCopyPending = false;
+        memcpy(dev->eeprom, &dev->scratchpad[2], 3);
+        simVar.stats.eepromWriteCount++;
+        return;
+    }
+
+    dev->isConvPending = false;
+
+    /* Quantize to configured resolution (undefined LSBs read as zero) */
+    uint8_t measRes = dev->isFake ? 3 : ((dev->scratchpad[4] >> 5) & 0x03);
+    int16_t rawTemp = (int16_t)lrintf(dev->temp * 16.0f);
+    rawTemp &= ~((1 << (3 - measRes)) - 1);
+
+    dev->scratchpad[0] = (uint16_t)rawTemp & 0xFF;
+    dev->scratchpad[1] = ((uint16_t)rawTemp >> 8) & 0xFF;
+    DeviceUpdateCrc(dev);
+
+    /* Alarm flag (integer part compared to signed TH/TL) */
+    int8_t tempIntgr = rawTemp >> 4;
+    dev->isAlarm = (tempIntgr >= (int8_t)dev->scratchpad[2]) ||
+                   (tempIntgr <= (int8_t)dev->scratchpad[3]);
+}
+
+
+/*
+ *  Parasite device loses power if pull-up ends or a slot starts before its
+ *  conversion or EEPROM copy is done
+ */
+static void DevicePowerLoss(SimDevice_t *dev)
+{
+    if (dev->isParasite && (dev->isConvPending || dev->isCopyPending) && (simVar.nowNs < dev->busyUntilNs))
+    {
+        dev->isPowered = false;
+    }
+}
+
+
+/*
+ *  Switch device protocol state
+ */
+static void DeviceEnterState(SimDevice_t *dev, DevState_t state)
+{
+    dev->state = state;
+    dev->bitIdx = 0;
+    dev->searchPhase = 0;
+    dev->rxData = 0;
+}
+
+
+/*
+ *  Bit transmitted by device in current slot (-1 if device is not sending)
+ */
+static int8_t DeviceTxBit(SimDevice_t *dev)
+{
+    uint8_t romBit = (dev->rom >> (dev->bitIdx & 0x3F)) & 0x01;
+
+    switch (dev->state)
+    {
+        case DEV_SEARCH_ROM:
+            if (dev->searchPhase == 2)
+            {
+                return -1;
+            }
+            return (dev->searchPhase == 0) ? romBit : !romBit;
+        case DEV_READ_ROM:
+            return romBit;
+        case DEV_READ_MEM:
+            if (dev->bitIdx >= 72)
+            {
+                return 1;
+            }
+            if (dev->isReadCorrupt && (dev->bitIdx == 0))
+            {
+                return !(dev->scratchpad[0] & 0x01);
+            }
+            return (dev->scratchpad[dev->bitIdx / 8] >> (dev->bitIdx % 8)) & 0x01;
+        case DEV_BUSY_POLL:
+            if (dev->isParasite)
+            {
+                return -1;  // No supply to drive status
+            }
+            return (simVar.nowNs >= dev->busyUntilNs) ? 1 : 0;
+        case DEV_READ_POWER:
+            return dev->isParasite ? 0 : 1;
+        default:
+            return -1;
+    }
+}
+
+
+/*
+ *  Device processes a finished slot
+ */
+static void DeviceSlotEnd(SimDevice_t *dev, uint8_t dataBit)
+{
+    uint8_t romBit = (dev->rom >> (dev->bitIdx & 0x3F)) & 0x01;
+
+    switch (dev->state)
+    {
+        case DEV_ROM_CMD:
+            dev->rxData |= (uint32_t)dataBit << dev->bitIdx;
+            if (++dev->bitIdx == 8)
+            {
+                DeviceRomCommand(dev, dev->rxData);
+            }
+            break;
+        case DEV_MATCH_ROM:
+            if (dataBit != romBit)
+            {
+                DeviceEnterState(dev, DEV_IDLE);
+            }
+            else if (++dev->bitIdx == 64)
+            {
+                DeviceEnterState(dev, DEV_FUNC_CMD);
+            }
+            break;
+        case DEV_SEARCH_ROM:
+            if (dev->searchPhase < 2)
+            {
+                dev->searchPhase++;
+            }
+            /* Master's direction choice deselects non-matching devices */
+            else if (dataBit != romBit)
+            {
+                DeviceEnterState(dev, DEV_IDLE);
+            }
+            else
+            {
+                dev->searchPhase = 0;
+                if (++dev->bitIdx == 64)
+                {
+                    DeviceEnterState(dev, DEV_FUNC_CMD);
+                }
+            }
+            break;
+        case DEV_READ_ROM:
+            if (++dev->bitIdx == 64)
+            {
+                DeviceEnterState(dev, DEV_FUNC_CMD);
+            }
+            break;
+        case DEV_FUNC_CMD:
+            dev->rxData |= (uint32_t)dataBit << dev->bitIdx;
+            if (++dev->bitIdx == 8)
+            {
+                DeviceFuncCommand(dev, dev->rxData);
+            }
+            break;
+        case DEV_WRITE_MEM:
+            dev->rxData |= (uint32_t)dataBit << (dev->bitIdx % 8);
+            /* TH, TL and configuration are stored byte by byte */
+            if ((++dev->bitIdx % 8) == 0)
+            {
+                uint8_t byteIdx = (dev->bitIdx / 8) - 1;
+                uint8_t dataByte = dev->rxData;
+
+                dev->scratchpad[2 + byteIdx] = (byteIdx == 2) ? ((dataByte & 0x60) | 0x1F) : dataByte;
+                dev->rxData = 0;
+                DeviceUpdateCrc(dev);
+
+                if (byteIdx == 2)
+                {
+                    DeviceEnterState(dev, DEV_IDLE);
+                }
+            }
+            break;
+        case DEV_READ_MEM:
+            if (dev->bitIdx < 72)
+            {
+                dev->bitIdx++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+
+/*
+ *  Execute received ROM command
+ */
+static void DeviceRomCommand(SimDevice_t *dev, uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case 0xF0:  // Search ROM
+            DeviceEnterState(dev, DEV_SEARCH_ROM);
+            break;
+        case 0xEC:  // Alarm search
+            DeviceEnterState(dev, dev->isAlarm ? DEV_SEARCH_ROM : DEV_IDLE);
+            break;
+        case 0x55:  // Match ROM
+            DeviceEnterState(dev, DEV_MATCH_ROM);
+            break;
+        case 0xCC:  // Skip ROM
+            DeviceEnterState(dev, DEV_FUNC_CMD);
+            break;
+        case 0x33:  // Read ROM
+            DeviceEnterState(dev, DEV_READ_ROM);
+            break;
+        default:
+            DeviceEnterState(dev, DEV_IDLE);
+            break;
+    }
+}
+
+
+/*
+ *  Execute received function command
+ */
+static void DeviceFuncCommand(SimDevice_t *dev, uint8_t cmd)
+{
+    uint8_t measRes = dev->isFake ? 3 : ((dev->scratchpad[4] >> 5) & 0x03);
+
+    switch (cmd)
+    {
+        case 0x44:  // Convert T
+            dev->isConvPending = true;
+            dev->isPowered = false;
+            dev->busyUntilNs = simVar.nowNs + (SIM_CONV_9BIT_NS << measRes);
+            DeviceEnterState(dev, DEV_BUSY_POLL);
+            break;
+        case 0x4E:  // Write scratch-pad
+            DeviceEnterState(dev, DEV_WRITE_MEM);
+            break;
+        case 0xBE:  // Read scratch-pad
+            DeviceEnterState(dev, DEV_READ_MEM);
+            dev->isReadCorrupt = (dev->readErrorCount > 0);
+            dev->readErrorCount -= dev->isReadCorrupt ? 1 : 0;
+            break;
+        case 0x48:  // Copy scratch-pad
+            if (dev->isParasite)
+            {
+                dev->isCopyPending = true;
+                dev->isPowered = false;
+            }
+            else
+            {
+                memcpy(dev->eeprom, &dev->scratchpad[2], 3);
+                simVar.stats.eepromWriteCount++;
+            }
+            dev->busyUntilNs = simVar.nowNs + SIM_COPY_MEM_NS;
+            DeviceEnterState(dev, DEV_BUSY_POLL);
+            break;
+        case 0xB8:  // Recall EEPROM
+            memcpy(&dev->scratchpad[2], dev->eeprom, 3);
+            DeviceUpdateCrc(dev);
+            dev->busyUntilNs = simVar.nowNs + SIM_RECALL_EEPROM_NS;
+            DeviceEnterState(dev, DEV_BUSY_POLL);
+            break;
+        case 0xB4:  // Read power supply
+            DeviceEnterState(dev, DEV_READ_POWER);
+            break;
+        default:
+            DeviceEnterState(dev, DEV_IDLE);
+            break;
+    }
+}
+
+
+/*
+ *  Recalculate scratch-pad CRC byte
+ */
+static void DeviceUpdateCrc(SimDevice_t *dev)
+{
+    dev->scratchpad[8] = Crc8(dev->scratchpad, 8);
+}
+
+
+/*
+ *  Bitwise Dallas/Maxim CRC-8 (independent of Edc.c on purpose)
+ */
+static uint8_t Crc8(const uint8_t *dataPtr, uint32_t dataLen)
+{
+    uint8_t crcVal = 0;
+
+    while (dataLen--)
+    {
+        uint8_t dataByte = *dataPtr++;
+
+        for (uint8_t idx = 0; idx < 8; idx++)
+        {
+            uint8_t mixBit = (crcVal ^ dataByte) & 0x01;
+            crcVal >>= 1;
+            crcVal ^= mixBit ? 0x8C : 0x00;
+            dataByte >>= 1;
+        }
+    }
+
+    return crcVal;
+}
@@ -0,0 +1,105 @@
+#ifndef OWSIM_H
+#define	OWSIM_H
+
+/*
+ *  Host-side virtual OneWire bus with simulated DS18B20 devices
+ *
+ *  The simulator implements the PIO, TMR, IC, OSC and core timer stand-ins
+ *  declared in this directory. Every OneWire slot generated by the driver is
+ *  decoded by the attached virtual devices from the wired-AND bus level, while
+ *  all delays advance a simulated clock instead of the wall clock. A UART
+ *  loopback (open-drain TX and RX on a bus pin) drives the same virtual bus
+ *  with 8N1 frames as a stand-in for the OneWireUart.c port hooks.
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Custom libs **/
+#include "OneWire.h"
+
+/******************************************************************************/
+/*---------------------------------Macros-------------------------------------*/
+/******************************************************************************/
+
+/** Simulator capacity **/
+#define OWSIM_MAX_BUS_COUNT         8
+#define OWSIM_MAX_DEVICE_COUNT      1024
+
+/** Default simulated system clock **/
+#define OWSIM_DEFAULT_SYSFREQ       40000000
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+
+/** Accumulated simulation counters (since last reset) **/
+typedef struct {
+    uint64_t    timeNs;         // Simulated time elapsed
+    uint64_t    busyNs;         // Time spent generating OW slots
+    uint64_t    maskedNs;       // Time with interrupts disabled
+    uint64_t    maxMaskedNs;    // Longest continuous masked window
+    uint64_t    isrNs;          // CPU time spent in simulated timer ISR
+    uint32_t    isrCount;       // Simulated timer ISR invocations
+    uint64_t    uartNs;         // CPU time spent setting up UART exchanges
+    uint32_t    resetCount;     // Reset pulses seen on all buses
+    uint32_t    slotCount;      // Read/write slots seen on all buses
+    uint32_t    eepromWriteCount; // EEPROM write cycles of all devices (copy scratch-pad)
+} OwSimStats_t;
+
+/** CPU cost model of the HAL stand-ins **/
+typedef struct {
+    uint32_t    pioNs;          // Per PIO_* call
+    uint32_t    delayNs;        // Per TMR_DelayUs call (setup overhead)
+    uint32_t    counterNs;      // Per _CP0_GET_COUNT call (polling loop)
+    uint32_t    isrNs;          // Per timer ISR (entry and exit)
+    uint32_t    uartNs;         // Per UART exchange or baud change (FIFO/DMA set-up)
+} OwSimCost_t;
+
+/** Simulated timer interrupt handler **/
+typedef void (*OwSimIsr_t)(void);
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+/** Simulator control **/
+void OWSIM_Init(uint32_t sysFreq);
+void OWSIM_SetCost(OwSimCost_t cost);
+void OWSIM_AdvanceUs(uint32_t delayUs);
+uint64_t OWSIM_GetTimeNs(void);
+void OWSIM_GetStats(OwSimStats_t *stats);
+void OWSIM_ResetStats(void);
+
+/** Simulated timer interrupt (fires while time advances, interrupts enabled) **/
+void OWSIM_SetTimerIsr(OwSimIsr_t timerIsr);
+void OWSIM_ArmTimerUs(uint32_t delayUs);
+
+/** UART loopback (8N1 frames on bus pin, OwUartPort_t hooks) **/
+bool OWSIM_AttachUart(const uint32_t pinCode);
+void OWSIM_UartSetBaud(uint32_t baudRate);
+void OWSIM_UartExchange(const uint8_t *txData, uint8_t *rxData, uint16_t dataLen);
+
+/** Bus and device set-up **/
+bool OWSIM_AddBus(const uint32_t pinCode, OwSpeedMode_t speedMode);
+void OWSIM_SetSpeedMode(const uint32_t pinCode, OwSpeedMode_t speedMode);
+bool OWSIM_SetPullupPin(const uint32_t pinCode, const uint32_t pullupPinCode, bool isActiveLow);
+int32_t OWSIM_AddDevice(const uint32_t pinCode, uint64_t romId);
+void OWSIM_SetTemp(int32_t devIdx, float temp);
+void OWSIM_SetFake(int32_t devIdx, bool isFake);
+void OWSIM_SetParasite(int32_t devIdx, bool isParasite);
+void OWSIM_SetReadErrors(int32_t devIdx, uint32_t errorCount);
+void OWSIM_SetDetached(int32_t devIdx, bool isDetached);
+
+/** Device inspection **/
+uint64_t OWSIM_GetRomId(int32_t devIdx);
+void OWSIM_GetScratchpad(int32_t devIdx, uint8_t *dataBuff);
+void OWSIM_GetEeprom(int32_t devIdx, uint8_t *dataBuff);
+bool OWSIM_IsAlarm(int32_t devIdx);
+
+#endif	/* OWSIM_H */
@@ -0,0 +1,127 @@
+#include <stdio.h>
+
+#include "OwVcd.h"
+
+/** VCD identifier of first variable (printable ASCII from '!') **/
+#define VCD_FIRST_ID            '!'
+
+/******************************************************************************/
+/*------------------------Local Function Prototypes---------------------------*/
+/******************************************************************************/
+
+static void WritePins(FILE *vcdFile, const uint8_t *pinIdx, uint8_t pinCount, uint32_t pinMask, uint32_t pinLevel, uint8_t idOffset);
+
+/******************************************************************************/
+/*----------------------External Function Definitions-------------------------*/
+/******************************************************************************/
+
+/*
+ *  Write recorded events of trace (oldest first) to VCD file, core timer
+ *  runs at sysFreq/2
+ */
+extern bool OWVCD_WriteTrace(const char *fileName, const OwTrace_t *trace, const uint32_t pinCode, uint32_t sysFreq)
+{
+    uint32_t pinMask = PIO_PIN_MASK(pinCode);
+    uint8_t pinIdx[OW_MAX_BUS_COUNT];
+    uint8_t pinCount = 0;
+
+    /* Inputs check */
+    if ((fileName == NULL) || (trace == NULL) || (pinMask == 0) || (sysFreq == 0))
+    {
+        return false;
+    }
+
+    FILE *vcdFile = fopen(fileName, "w");
+    if (vcdFile == NULL)
+    {
+        return false;
+    }
+
+    for (uint8_t pin = 0; pin < OW_MAX_BUS_COUNT; pin++)
+    {
+        if (pinMask & (1UL << pin))
+        {
+            pinIdx[pinCount++] = pin;
+        }
+    }
+
+    /* Header: line and level wire per pin, shared sample event */
+    fprintf(vcdFile, "$timescale 1ns $end\n$scope module ow $end\n");
+    for (uint8_t idx = 0; idx < pinCount; idx++)
+    {
+        char portName = 'a' + PIO_PIN_PORT(pinCode);
+
+        fprintf(vcdFile, "$var wire 1 %c r%c%u_line $end\n", VCD_FIRST_ID + 2 * idx, portName, pinIdx[idx]);
+        fprintf(vcdFile, "$var wire 1 %c r%c%u_level $end\n", VCD_FIRST_ID + 2 * idx + 1, portName, pinIdx[idx]);
+    }
+    fprintf(vcdFile, "$var event 1 %c sample $end\n", VCD_FIRST_ID + 2 * pinCount);
+    fprintf(vcdFile, "$upscope $end\n$enddefinitions $end\n");
+
+    /* Idle bus: released, level unknown until first sample */
+    fprintf(vcdFile, "#0\n$dumpvars\n");
+    for (uint8_t idx = 0; idx < pinCount; idx++)
+    {
+        fprintf(vcdFile, "1%c\nx%c\n", VCD_FIRST_ID + 2 * idx, VCD_FIRST_ID + 2 * idx + 1);
+    }
+    fprintf(vcdFile, "$end\n");
+
+    /* Events (timestamps unwrapped across core timer overflow) */
+    uint64_t elapsedTicks = 0, eventNs, lastNs = 0;
+    uint32_t lastTick = 0;
+
+    for (uint16_t eventIdx = 0; eventIdx < trace->count; eventIdx++)
+    {
+        const OwTraceEvent_t *event = OW_GetTraceEvent(trace, eventIdx);
+
+        elapsedTicks += (eventIdx == 0) ? 0 : (uint32_t)(event->tick - lastTick);
+        lastTick = event->tick;
+
+        /* Time stamps must increase */
+        eventNs = (elapsedTicks * 2000000000ULL) / sysFreq;
+        if ((eventIdx == 0) || (eventNs > lastNs))
+        {
+            fprintf(vcdFile, "#%llu\n", (unsigned long long)eventNs);
+            lastNs = eventNs;
+        }
+
+        switch (event->type)
+        {
+            case OW_TRACE_PULL:
+                WritePins(vcdFile, pinIdx, pinCount, event->pinMask, 0, 0);
+                break;
+            case OW_TRACE_RELEASE:
+                WritePins(vcdFile, pinIdx, pinCount, event->pinMask, 0xFFFFFFFF, 0);
+                break;
+            case OW_TRACE_SAMPLE:
+                WritePins(vcdFile, pinIdx, pinCount, pinMask, event->pinMask, 1);
+                fprintf(vcdFile, "1%c\n", VCD_FIRST_ID + 2 * pinCount);
+                break;
+            default:
+                break;
+        }
+    }
+
+    fclose(vcdFile);
+
+    return true;
+}
+
+/******************************************************************************/
+/*------------------------Local Function Definitions--------------------------*/
+/******************************************************************************/
+
+/*
+ *  Write value changes of pins in "pinMask" (idOffset 0 - line, 1 - level)
+ */
+static void WritePins(FILE *vcdFile, const uint8_t *pinIdx, uint8_t pinCount, uint32_t pinMask, uint32_t pinLevel, uint8_t idOffset)
+{
+    for (uint8_t idx = 0; idx < pinCount; idx++)
+    {
+        uint32_t pinBit = 1UL << pinIdx[idx];
+
+        if (pinMask & pinBit)
+        {
+            fprintf(vcdFile, "%c%c\n", (pinLevel & pinBit) ? '1' : '0', VCD_FIRST_ID + 2 * idx + idOffset);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef OWVCD_H
+#define	OWVCD_H
+
+/*
+ *  Value Change Dump export of OneWire slot traces (OW_ConfigTrace)
+ *
+ *  Every pin of the traced bus (or pin group) becomes a "line" wire holding
+ *  the level driven by the master (0 - pulled LOW, 1 - released) and a
+ *  "level" wire holding the last sampled pin level. Sample instants are
+ *  marked by a shared "sample" event. Core timer ticks are converted to
+ *  nanoseconds, so the file opens with 1 ns resolution in GTKWave.
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Custom libs **/
+#include "OneWire.h"
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+bool OWVCD_WriteTrace(const char *fileName, const OwTrace_t *trace, const uint32_t pinCode, uint32_t sysFreq);
+
+#endif	/* OWVCD_H */
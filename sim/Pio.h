@@ -0,0 +1,83 @@
+#ifndef PIO_H
+#define	PIO_H
+
+/*
+ *  Host stand-in for the PIC32MX GPIO library (simulated)
+ *  Pin code holds port index in upper half-word and pin bit mask in lower one.
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+
+/******************************************************************************/
+/*---------------------------------Macros-------------------------------------*/
+/******************************************************************************/
+
+/** Pin code construction **/
+#define PIO_PORT_A                  0
+#define PIO_PORT_B                  1
+#define PIO_PORT_C                  2
+#define PIO_PORT_COUNT              3
+
+#define PIO_PIN_CODE(port, pin)     (((uint32_t)(port) << 16) | (1UL << (pin)))
+#define PIO_PIN_PORT(pinCode)       ((pinCode) >> 16)
+#define PIO_PIN_MASK(pinCode)       ((pinCode) & 0xFFFF)
+
+/** Pin codes **/
+#define GPIO_RPA0                   PIO_PIN_CODE(PIO_PORT_A, 0)
+#define GPIO_RPA1                   PIO_PIN_CODE(PIO_PORT_A, 1)
+#define GPIO_RPA2                   PIO_PIN_CODE(PIO_PORT_A, 2)
+#define GPIO_RPA3                   PIO_PIN_CODE(PIO_PORT_A, 3)
+#define GPIO_RPA4                   PIO_PIN_CODE(PIO_PORT_A, 4)
+#define GPIO_RPB0                   PIO_PIN_CODE(PIO_PORT_B, 0)
+#define GPIO_RPB1                   PIO_PIN_CODE(PIO_PORT_B, 1)
+#define GPIO_RPB2                   PIO_PIN_CODE(PIO_PORT_B, 2)
+#define GPIO_RPB3                   PIO_PIN_CODE(PIO_PORT_B, 3)
+#define GPIO_RPB4                   PIO_PIN_CODE(PIO_PORT_B, 4)
+#define GPIO_RPB5                   PIO_PIN_CODE(PIO_PORT_B, 5)
+#define GPIO_RPB6                   PIO_PIN_CODE(PIO_PORT_B, 6)
+#define GPIO_RPB7                   PIO_PIN_CODE(PIO_PORT_B, 7)
+#define GPIO_RPB8                   PIO_PIN_CODE(PIO_PORT_B, 8)
+#define GPIO_RPB9                   PIO_PIN_CODE(PIO_PORT_B, 9)
+#define GPIO_RPB10                  PIO_PIN_CODE(PIO_PORT_B, 10)
+#define GPIO_RPB11                  PIO_PIN_CODE(PIO_PORT_B, 11)
+#define GPIO_RPB12                  PIO_PIN_CODE(PIO_PORT_B, 12)
+#define GPIO_RPB13                  PIO_PIN_CODE(PIO_PORT_B, 13)
+#define GPIO_RPB14                  PIO_PIN_CODE(PIO_PORT_B, 14)
+#define GPIO_RPB15                  PIO_PIN_CODE(PIO_PORT_B, 15)
+#define GPIO_RPC0                   PIO_PIN_CODE(PIO_PORT_C, 0)
+#define GPIO_RPC1                   PIO_PIN_CODE(PIO_PORT_C, 1)
+#define GPIO_RPC2                   PIO_PIN_CODE(PIO_PORT_C, 2)
+#define GPIO_RPC3                   PIO_PIN_CODE(PIO_PORT_C, 3)
+
+/******************************************************************************/
+/*----------------------------Enumeration Types-------------------------------*/
+/******************************************************************************/
+
+typedef enum {
+    PIO_TYPE_DIGITAL = 0,
+    PIO_TYPE_ANALOG = 1
+} PioType_t;
+
+typedef enum {
+    PIO_DIR_OUTPUT = 0,
+    PIO_DIR_INPUT = 1
+} PioDir_t;
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+void PIO_ConfigGpioPin(const uint32_t pinCode, PioType_t pinType, PioDir_t pinDir);
+void PIO_ConfigGpioPinDir(const uint32_t pinCode, PioDir_t pinDir);
+void PIO_SetPin(const uint32_t pinCode);
+void PIO_ClearPin(const uint32_t pinCode);
+void PIO_TogglePin(const uint32_t pinCode);
+uint8_t PIO_ReadPin(const uint32_t pinCode);
+uint32_t PIO_ReadPort(const uint32_t pinCode);
+
+#endif	/* PIO_H */
@@ -0,0 +1,37 @@
+#ifndef SFR_TYPES_H
+#define	SFR_TYPES_H
+
+/*
+ *  Host stand-in for the PIC32MX peripheral library header of the same name.
+ *  Only the subset used by the OneWire and DS18B20 drivers is provided.
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Custom libs **/
+#include "Ic.h"
+#include "Osc.h"
+
+/******************************************************************************/
+/*---------------------------------Macros-------------------------------------*/
+/******************************************************************************/
+
+#ifndef INLINE
+#define INLINE  inline __attribute__ ((always_inline))
+#endif
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+/** Core timer (counts at SYSCLK/2 like CP0 Count register) **/
+uint32_t _CP0_GET_COUNT(void);
+
+#endif	/* SFR_TYPES_H */
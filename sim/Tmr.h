@@ -0,0 +1,22 @@
+#ifndef TMR_H
+#define	TMR_H
+
+/*
+ *  Host stand-in for the PIC32MX timer library (simulated)
+ *  TMR_DELAY_SYSCLK is accepted for source compatibility but not required.
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+
+/** Standard libs **/
+#include <stdint.h>
+
+/******************************************************************************/
+/*---------------------------- Function Prototypes----------------------------*/
+/******************************************************************************/
+
+void TMR_DelayUs(uint32_t delayUs);
+
+#endif	/* TMR_H */